@@ -0,0 +1,96 @@
+/*
+ *  Measures splitting TSV-lines into fields with the Delimiter_Scanner (scan_line) against the scalar search for tabs
+ *  and newlines (next_line and split_on_tab). Run with a file to split, e.g. a model or an edge-file. Without one, a
+ *  synthetic edge-list the size of the largest bundled model (dblp_citation_model.m1, 48 MB) is split.
+ */
+
+#include "../src/m1ModelFormat.cpp"
+#include "../src/m1BinaryFormat.cpp"
+#include "../src/GenericGraphReader.cpp"
+#include "../src/ExternalGraphReader.cpp"
+#include "../src/TSVReader.cpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+constexpr size_t SYNTHETIC_SIZE = 48 * 1024 * 1024;
+constexpr size_t MAX_COLUMNS = 3;
+constexpr int REPETITIONS = 5;
+
+// Edge-list with three columns: start- and end-node and the edge-type.
+std::string synthetic_edge_list() {
+    std::mt19937_64 rng(42);
+    std::string buffer;
+    buffer.reserve(SYNTHETIC_SIZE + 64);
+    while (buffer.size() < SYNTHETIC_SIZE) {
+        buffer += std::to_string(rng() % 10000000) + '\t' + std::to_string(rng() % 10000000) + "\tcites\n";
+    }
+    return buffer;
+}
+
+// Best time of a few repetitions. Fields are summed up, so the splitting is not optimized away.
+template <typename Function>
+double seconds_to_split(const std::string_view buffer, size_t& n_fields, const Function& split) {
+    double best = std::numeric_limits<double>::max();
+    for (int repetition = 0; repetition < REPETITIONS; ++repetition) {
+        const auto start = std::chrono::steady_clock::now();
+        n_fields = split(buffer);
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    std::string buffer;
+    if (argc > 1) {
+        std::ifstream file(argv[1], std::ios::binary);
+        if (!file) {
+            std::cerr << "Could not open '" << argv[1] << "'." << std::endl;
+            return 1;
+        }
+        std::stringstream content;
+        content << file.rdbuf();
+        buffer = content.str();
+    } else {
+        buffer = synthetic_edge_list();
+    }
+
+    size_t scalar_fields = 0;
+    const double scalar = seconds_to_split(buffer, scalar_fields, [](const std::string_view content) {
+        std::vector<std::string_view> fields;
+        size_t n_fields = 0;
+        size_t pos = 0;
+        while (pos < content.size()) {
+            n_fields += split_on_tab(next_line(content, pos), fields, MAX_COLUMNS);
+        }
+        return n_fields;
+    });
+
+    size_t scanner_fields = 0;
+    const double scanner = seconds_to_split(buffer, scanner_fields, [](const std::string_view content) {
+        std::vector<std::string_view> fields;
+        std::string_view line;
+        Delimiter_Scanner delimiters(content);
+        size_t n_fields = 0;
+        size_t pos = 0;
+        while (pos < content.size()) {
+            n_fields += scan_line(content, delimiters, pos, fields, MAX_COLUMNS, line);
+        }
+        return n_fields;
+    });
+
+    if (scalar_fields != scanner_fields) {
+        std::cerr << "Field counts differ: " << scalar_fields << " (scalar) vs. " << scanner_fields << " (scanner)." << std::endl;
+        return 1;
+    }
+    const double megabytes = static_cast<double>(buffer.size()) / (1024 * 1024);
+    std::cout << "Split " << megabytes << " MB into " << scanner_fields << " fields (best of " << REPETITIONS << ")." << std::endl;
+    std::cout << "\tnext_line + split_on_tab: " << scalar << " s (" << megabytes / scalar << " MB/s)" << std::endl;
+    std::cout << "\tDelimiter_Scanner:        " << scanner << " s (" << megabytes / scanner << " MB/s)" << std::endl;
+    return 0;
+}
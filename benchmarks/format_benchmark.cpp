@@ -0,0 +1,52 @@
+/*
+ *  Measures unsafe_u64Int_to_str against std::to_chars on NodeIDs of every digit count, as they are written to the
+ *  node- and edge-files. Run with the number of values to format (default 20000000).
+ */
+
+#include "../src/graphgenerator_format.h"
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+template <typename Function>
+double seconds_to_format(const std::vector<std::uint64_t>& values, std::vector<char>& output, const Function& format) {
+    const auto start = std::chrono::steady_clock::now();
+    char* position = output.data();
+    for (const std::uint64_t value: values) {
+        position += format(position, value);
+        *position++ = '\n';
+    }
+    const auto end = std::chrono::steady_clock::now();
+    // Keep the output alive, so the formatting is not optimized away.
+    volatile char sink = output[static_cast<size_t>(position - output.data()) / 2];
+    (void) sink;
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char** argv) {
+    const size_t n_values = argc > 1 ? std::stoull(argv[1]) : 20000000;
+
+    // Uniform over the digit counts, the way IDs of graphs of different sizes are spread.
+    std::mt19937_64 rng(42);
+    std::vector<std::uint64_t> values(n_values);
+    for (auto& value: values) {
+        const int digits = static_cast<int>(rng() % 20);
+        value = digits == 0 ? rng() % 10 : POWERS_OF_10[digits - 1] + rng() % (POWERS_OF_10[digits - 1] * 9);
+    }
+    std::vector<char> output(n_values * 22);
+
+    const double table = seconds_to_format(values, output, [](char* target, const std::uint64_t value) {
+        return unsafe_u64Int_to_str(target, value);
+    });
+    const double to_chars = seconds_to_format(values, output, [&output](char* target, const std::uint64_t value) {
+        return static_cast<int>(std::to_chars(target, output.data() + output.size(), value).ptr - target);
+    });
+
+    std::cout << "Formatted " << n_values << " values." << std::endl;
+    std::cout << "\tunsafe_u64Int_to_str: " << table << " s (" << n_values / table / 1e6 << " M values/s)" << std::endl;
+    std::cout << "\tstd::to_chars:        " << to_chars << " s (" << n_values / to_chars / 1e6 << " M values/s)" << std::endl;
+    return 0;
+}
@@ -2,7 +2,10 @@
 #include <iostream>
 
 #include "src/m1ModelFormat.cpp"
+#include "src/m1BinaryFormat.cpp"
+#include "src/m1ModelStream.cpp"
 #include "src/GenericGraphReader.cpp"
+#include "src/ExternalGraphReader.cpp"
 #include "src/TSVReader.cpp"
 #include "src/Generator.cpp"
 #include "src/s1ScriptFormat.cpp"
@@ -42,7 +45,10 @@ int main(int argc, char * argv[]) {
     std::vector<Instruction> instructions = parse_s1_file(tokens);
     m1_data active_model = {};
     bool has_active_model = false;
+    // A streamed model only holds the meta-data and the nodes, its blocks are read from the file on generation.
+    std::string streamed_model_file;
     std::mt19937_64 rng_seeds {std::random_device()()};
+    Generation_Settings generation_settings = {};
 
     size_t available_instructions = instructions.size();
     while (instruction_counter < available_instructions) {
@@ -55,10 +61,22 @@ int main(int argc, char * argv[]) {
                 auto tsv_reader = TSVReader(current_instruction.read.node_files, current_instruction.read.edge_files,
                     current_instruction.read.node_name_index, current_instruction.read.node_type_indices,
                     current_instruction.read.start_node_index, current_instruction.read.end_node_index, current_instruction.read.edge_type_indices);
-                GenericGraphReader model = {};
-
-                active_model = tsv_reader.readTo(model, current_instruction.read.data, rng_seeds());
+                if (current_instruction.read.memory_budget > 0) {
+                    const std::filesystem::path temp_directory = current_instruction.read.temp_directory.empty()
+                        ? std::filesystem::temp_directory_path() : std::filesystem::path(current_instruction.read.temp_directory);
+                    std::cout << "\tReading on disk in '" << temp_directory.string() << "' with a memory budget of "
+                        << current_instruction.read.memory_budget << " MB." << std::endl;
+                    ExternalGraphReader model(current_instruction.read.memory_budget << 20, temp_directory,
+                        current_instruction.read.node_id_mode);
+                    active_model = tsv_reader.readTo(model, current_instruction.read.data, rng_seeds(),
+                        current_instruction.read.degree_classes);
+                } else {
+                    GenericGraphReader model(current_instruction.read.node_id_mode, current_instruction.read.degree_aggregation);
+                    active_model = tsv_reader.readTo(model, current_instruction.read.data, rng_seeds(),
+                        current_instruction.read.degree_classes);
+                }
                 has_active_model = true;
+                streamed_model_file.clear();
                 break;
             }
 
@@ -98,9 +116,17 @@ int main(int argc, char * argv[]) {
                 std::cout << "[" << instruction_counter << "] Generating " << to_generate << " new graph(s) at "
                     << active_model.meta.values["SCALE"] << "x scale." << std::endl;
 
+                auto generate = [&](const std::string& n_file, const std::string& e_file) {
+                    if (streamed_model_file.empty()) {
+                        generate_graph(n_file, e_file, active_model, rng_seeds(), generation_settings);
+                    } else {
+                        generate_streamed_graph(n_file, e_file, active_model, streamed_model_file, rng_seeds(), generation_settings);
+                    }
+                };
+
                 if (current_instruction.generate.n_to_generate == 1) {
                     // Single generation is handled separately, as the path does not need to be edited.
-                    generate_graph(current_instruction.generate.nodefile_path, current_instruction.generate.edge_file_path, active_model, rng_seeds());
+                    generate(current_instruction.generate.nodefile_path, current_instruction.generate.edge_file_path);
                     std::cout << "\t1.) at '" << current_instruction.generate.nodefile_path << "' and '" << current_instruction.generate.edge_file_path << "'." << std::endl;
                     ++generation_counter;
                 } else {
@@ -114,7 +140,7 @@ int main(int argc, char * argv[]) {
                         std::string e_file = edge_path.parent_path().string() + '/' + edge_path.stem().string()
                             + '_' + std::to_string(i) + edge_path.extension().string();
                         std::cout << '\t' << (i+1) << ".) at '" << n_file << "' and '" << e_file << "'." << std::endl;
-                        generate_graph(n_file, e_file, active_model, rng_seeds());
+                        generate(n_file, e_file);
                         ++generation_counter;
                     }
 
@@ -127,7 +153,7 @@ int main(int argc, char * argv[]) {
                     throw std::runtime_error("A model needs to be active before it can be scaled. Use -read or -load before scaling.");
                 }
                 std::cout << "[" << instruction_counter << "] Scaling model by a factor of x" << current_instruction.f_val << "." << std::endl;
-                active_model = scale_m1_data(active_model, current_instruction.f_val);
+                scale_m1_data(active_model, current_instruction.f_val);
                 break;
             }
 
@@ -135,20 +161,35 @@ int main(int argc, char * argv[]) {
                 if (!has_active_model) {
                     throw std::runtime_error("A model needs to be active before it can be saved to a file. Use -read or -load before saving.");
                 }
+                if (!streamed_model_file.empty()) {
+                    throw std::runtime_error("A streamed model can not be saved. Use -load instead of -stream before saving.");
+                }
                 std::cout << "[" << instruction_counter << "] Saving model '" << active_model.meta.name <<"' to '"
                     << current_instruction.s_val << "'." << std::endl;
-                size_t bytes_written = write_m1_file(current_instruction.s_val, active_model);
+                size_t bytes_written = save_m1_model(current_instruction.s_val, active_model);
                 std::cout << "\tWrote " << bytes_written / 1.0e9L << " GB to the file." << std::endl;
                 break;
             }
 
             case Instruction_Type::ILoad: {
                 std::cout << "[" << instruction_counter << "] Reading model from '" << current_instruction.s_val <<"'." << std::endl;
-                active_model = read_m1_file(current_instruction.s_val);
+                active_model = load_m1_model(current_instruction.s_val);
+                has_active_model = true;
+                streamed_model_file.clear();
                 std::cout << "\tActive Model: " << active_model.meta.name << std::endl;
                 break;
             }
 
+            case Instruction_Type::IStream: {
+                std::cout << "[" << instruction_counter << "] Streaming model from '" << current_instruction.s_val <<"'." << std::endl;
+                active_model = M1_Block_Stream(current_instruction.s_val).header();
+                has_active_model = true;
+                streamed_model_file = current_instruction.s_val;
+                std::cout << "\tActive Model: " << active_model.meta.name << " (" << active_model.nodes.size()
+                    << " type(s) of nodes, edges are read on generation)" << std::endl;
+                break;
+            }
+
             case Instruction_Type::ISeed: {
                 std::cout << "[" << instruction_counter << "] Setting the random seed to '" << current_instruction.s_val << "'." << std::endl;
                 std::seed_seq rng = {current_instruction.s_val.begin(), current_instruction.s_val.end()};
@@ -156,6 +197,20 @@ int main(int argc, char * argv[]) {
                 break;
             }
 
+            case Instruction_Type::IThreads: {
+                generation_settings.n_threads = current_instruction.u_val;
+                std::cout << "[" << instruction_counter << "] Using " << resolve_thread_count(generation_settings)
+                    << " thread(s) for generation." << std::endl;
+                break;
+            }
+
+            case Instruction_Type::IAffinity: {
+                generation_settings.pin_threads = current_instruction.s_val == "ON";
+                std::cout << "[" << instruction_counter << "] Thread affinity for generation turned "
+                    << (generation_settings.pin_threads ? "on." : "off.") << std::endl;
+                break;
+            }
+
             case Instruction_Type::IHelp: {
                 std::cout << "[" << instruction_counter << "] Displaying program help." << std::endl;
                 std::cout << "\tUse double-quotations (\"...\") to retain tabs/spaces/linebreaks within an argument. Instructions are not case-sensitive." << std::endl << std::endl;
@@ -167,15 +222,23 @@ int main(int argc, char * argv[]) {
                 std::cout << "\t\t\t+nodetypeindex [index_of_node_type1] [index_of_node_type2] ..." << std::endl;
                 std::cout << "\t\t\t+edgeindex [index_of_start_node] [index_of_end_node]" << std::endl;
                 std::cout << "\t\t\t+edgetypeindex [index_of_edge_type1] [index_of_edge_type2] ..." << std::endl;
+                std::cout << "\t\t\t+nodeids [auto|numeric|text]" << std::endl;
+                std::cout << "\t\t\t+aggregation [records|sort]" << std::endl;
+                std::cout << "\t\t\t+degreeclasses [log|count] [ratio|number_of_classes]" << std::endl;
+                std::cout << "\t\t\t+memory [memory_budget_in_MB]" << std::endl;
+                std::cout << "\t\t\t+tempdir [path_to_temporary_directory]" << std::endl;
                 std::cout << "\t\t\t+arg [KEY] [VALUE]" << std::endl << std::endl;
 
                 std::cout << "\t### Execute a script. Non-destructively replaces templates with replaces." << std::endl;
                 std::cout << "\t\t-Execute [path_to_script] [template1] [replace1] [template2] [replace2] ..." << std::endl << std::endl;
 
-                std::cout << "\t### Load a model from a file. Set it as the active model." << std::endl;
+                std::cout << "\t### Load a model from a file. Set it as the active model. Models may be gzip-, zstd- or zip-compressed." << std::endl;
                 std::cout << "\t\t-Load [path_to_model_file]" << std::endl << std::endl;
 
-                std::cout << "\t### Save the currently active model to a file." << std::endl;
+                std::cout << "\t### Use a model-file as the active model, without loading its edges into memory. They are read while generating." << std::endl;
+                std::cout << "\t\t-Stream [path_to_model_file]" << std::endl << std::endl;
+
+                std::cout << "\t### Save the currently active model to a file. Files ending in '.m1b' are written in the binary format, '.gz' and '.zst' are compressed." << std::endl;
                 std::cout << "\t\t-Save [model_save_path]" << std::endl << std::endl;
 
                 std::cout << "\t### Scale the currently active model by the given factor. Scaling below x1.0 is not recommended." << std::endl;
@@ -187,6 +250,12 @@ int main(int argc, char * argv[]) {
                 std::cout << "\t### Generate n new graphs from the currently active model at the current scale." << std::endl;
                 std::cout << "\t\t-Generate [generated_nodefile_path] [generated_edgefile_path] [number_of_graphs]" << std::endl << std::endl;
 
+                std::cout << "\t### Set the number of threads used for generation. 0 uses all but one of the available hardware threads." << std::endl;
+                std::cout << "\t\t-Threads [number_of_threads]" << std::endl << std::endl;
+
+                std::cout << "\t### Pin the threads used for generation to individual cores, keeping their data local to the core." << std::endl;
+                std::cout << "\t\t-Affinity [on|off]" << std::endl << std::endl;
+
                 std::cout << "\t### Display this short usage documentation." << std::endl;
                 std::cout << "\t\t-Helo" << std::endl;
                 break;
@@ -0,0 +1,333 @@
+#include <charconv>
+#include <filesystem>
+#include <random>
+#include "../src/graphgenerator_external_sort.h"
+
+
+// Records of the external reader. Node-IDs are kept as text, edges are split into two halves: The start (role 0) and
+//  the end (role 1) of the edge. A half is identified by 2 * edge_number + role.
+struct Node_Entry {
+    std::string name;
+    std::uint64_t sequence = 0;     // Position in the node-files. Later definitions of a node overwrite earlier ones.
+    Type_ID node_type = 0;
+
+    bool operator<(const Node_Entry& other) const {
+        if (const int c = this->name.compare(other.name); c != 0) {return c < 0;}
+        return this->sequence < other.sequence;
+    }
+    [[nodiscard]] size_t memory_size() const {return sizeof(Node_Entry) + this->name.capacity();}
+    void write(std::ostream& output) const {
+        write_binary_string(output, this->name);
+        write_binary(output, this->sequence);
+        write_binary(output, this->node_type);
+    }
+    bool read(std::istream& input) {
+        return read_binary_string(input, this->name) && read_binary(input, this->sequence) && read_binary(input, this->node_type);
+    }
+};
+
+struct Endpoint_Entry {
+    std::string name;
+    std::uint64_t half = 0;
+    Type_ID edge_type = 0;
+
+    bool operator<(const Endpoint_Entry& other) const {
+        if (const int c = this->name.compare(other.name); c != 0) {return c < 0;}
+        return this->half < other.half;
+    }
+    [[nodiscard]] size_t memory_size() const {return sizeof(Endpoint_Entry) + this->name.capacity();}
+    void write(std::ostream& output) const {
+        write_binary_string(output, this->name);
+        write_binary(output, this->half);
+        write_binary(output, this->edge_type);
+    }
+    bool read(std::istream& input) {
+        return read_binary_string(input, this->name) && read_binary(input, this->half) && read_binary(input, this->edge_type);
+    }
+};
+
+// An endpoint after it was resolved to the rank of its node among all distinct nodes.
+struct Edge_Half {
+    static constexpr std::uint64_t UNKNOWN_NODE = std::numeric_limits<std::uint64_t>::max();
+
+    std::uint64_t half = 0;
+    std::uint64_t node = UNKNOWN_NODE;
+    Type_ID node_type = 0;
+    Type_ID edge_type = 0;
+
+    bool operator<(const Edge_Half& other) const {return this->half < other.half;}
+    [[nodiscard]] size_t memory_size() const {return sizeof(Edge_Half);}
+    void write(std::ostream& output) const {write_binary(output, *this);}
+    bool read(std::istream& input) {return read_binary(input, *this);}
+};
+
+// A single unit of degree of a node. Equal entries are adjacent once sorted, so their count is the degree.
+struct Degree_Entry {
+    std::uint64_t node = 0;
+    Type_ID edge_type = 0;
+    Type_ID direction = 0;          // 0 for out-degrees, 1 for in-degrees.
+    Type_ID node_type = 0;
+
+    [[nodiscard]] bool same_degree(const Degree_Entry& other) const {
+        return this->node == other.node && this->edge_type == other.edge_type && this->direction == other.direction;
+    }
+    bool operator<(const Degree_Entry& other) const {
+        if (this->node != other.node) {return this->node < other.node;}
+        if (this->edge_type != other.edge_type) {return this->edge_type < other.edge_type;}
+        return this->direction < other.direction;
+    }
+    [[nodiscard]] size_t memory_size() const {return sizeof(Degree_Entry);}
+    void write(std::ostream& output) const {write_binary(output, *this);}
+    bool read(std::istream& input) {return read_binary(input, *this);}
+};
+
+
+// Reads graphs that are larger than the available memory. Instead of keeping a record per node, all nodes and
+//  endpoints of edges are written to sorted runs on disk. The runs are merged to resolve the endpoints to their nodes,
+//  then to pair the endpoints of every edge and finally to count the degrees of every node. Only the types, the
+//  SBM-Matrices and the degree-distributions are held in memory. Produces the same model as GenericGraphReader.
+//
+// Edges are resolved only once all nodes and edges are read, unknown nodes are thus reported by process().
+class ExternalGraphReader {
+public:
+    // Memory used for buffered records is roughly bounded by the given budget (in bytes). Runs are written to a new
+    //  directory within the given one, which is removed with the reader.
+    ExternalGraphReader(size_t memory_budget_, const std::filesystem::path& temp_directory,
+        Node_ID_Mode id_mode_ = Node_ID_Mode::Auto);
+    ~ExternalGraphReader();
+
+    ExternalGraphReader(const ExternalGraphReader&) = delete;
+    ExternalGraphReader& operator=(const ExternalGraphReader&) = delete;
+
+    // The external reader reads every file on a single thread.
+    static constexpr bool SUPPORTS_PARTIALS = false;
+
+    Type_ID internNodeType(std::span<const std::string_view> columns, std::span<const size_t> indices);
+    Type_ID internEdgeType(std::span<const std::string_view> columns, std::span<const size_t> indices);
+
+    Read_Result readNode(std::string_view node, Type_ID node_type);
+    Read_Result readEdge(std::string_view start, std::string_view end, Type_ID edge_type);
+
+    // Called once all nodes are read. Sorts the remaining nodes.
+    void finishNodes();
+
+    [[nodiscard]] Node_ID_Mode nodeIDMode() const {return this->id_mode;}
+
+    m1_data process(std::map<std::string, std::string> meta_data, std::mt19937_64::result_type seed,
+        const Degree_Classes& degree_classes = {});
+
+    Amount node_count = 0;
+
+private:
+    // Node-IDs are compared as text. In Numeric mode they are rewritten without leading zeros first.
+    //  Returns false for IDs that are not accepted.
+    bool canonical_name(std::string_view node, std::string& name) const;
+
+    Node_ID_Mode id_mode;
+    size_t memory_budget;
+    std::filesystem::path run_directory;
+
+    std::unique_ptr<External_Sorter<Node_Entry> > nodes;
+    std::unique_ptr<External_Sorter<Endpoint_Entry> > endpoints;
+    std::uint64_t edges_read = 0;
+
+    Type_Table node_types;
+    Type_Table edge_types;
+    std::vector<Amount> node_type_counts;
+};
+
+
+ExternalGraphReader::ExternalGraphReader(const size_t memory_budget_, const std::filesystem::path& temp_directory,
+    const Node_ID_Mode id_mode_): id_mode(id_mode_), memory_budget(memory_budget_) {
+    // Use a fresh directory, so concurrent runs of the generator do not collide.
+    std::random_device random;
+    do {
+        this->run_directory = temp_directory / ("graphgenerator_" + std::to_string(random()) + std::to_string(random()));
+    } while (std::filesystem::exists(this->run_directory));
+    if (!std::filesystem::create_directories(this->run_directory)) {
+        throw std::runtime_error("Could not create the temporary directory '" + this->run_directory.string() + "'.");
+    }
+
+    // The nodes and endpoints are buffered at the same time.
+    this->nodes = std::make_unique<External_Sorter<Node_Entry> >(this->run_directory / "nodes", this->memory_budget / 2);
+    this->endpoints = std::make_unique<External_Sorter<Endpoint_Entry> >(this->run_directory / "endpoints", this->memory_budget / 2);
+}
+
+
+ExternalGraphReader::~ExternalGraphReader() {
+    // Close all runs before removing them.
+    this->nodes.reset();
+    this->endpoints.reset();
+    std::error_code ignored;
+    std::filesystem::remove_all(this->run_directory, ignored);
+}
+
+
+Type_ID ExternalGraphReader::internNodeType(const std::span<const std::string_view> columns, const std::span<const size_t> indices) {
+    const Type_ID id = this->node_types.intern(columns, indices);
+    if (id >= this->node_type_counts.size()) {this->node_type_counts.resize(id + 1, 0);}
+    return id;
+}
+
+
+Type_ID ExternalGraphReader::internEdgeType(const std::span<const std::string_view> columns, const std::span<const size_t> indices) {
+    return this->edge_types.intern(columns, indices);
+}
+
+
+bool ExternalGraphReader::canonical_name(const std::string_view node, std::string& name) const {
+    if (this->id_mode != Node_ID_Mode::Numeric) {
+        name.assign(node);
+        return true;
+    }
+    std::uint64_t number;
+    const auto result = std::from_chars(node.data(), node.data() + node.size(), number);
+    if (node.empty() || result.ec != std::errc() || result.ptr != node.data() + node.size()) {return false;}
+    char buffer[24];
+    name.assign(buffer, std::to_chars(buffer, buffer + sizeof(buffer), number).ptr);
+    return true;
+}
+
+
+Read_Result ExternalGraphReader::readNode(const std::string_view node, const Type_ID node_type) {
+    Node_Entry entry;
+    if (!this->canonical_name(node, entry.name)) {return Read_Invalid_ID;}
+    entry.sequence = this->node_count;
+    entry.node_type = node_type;
+    this->nodes->add(std::move(entry));
+
+    ++this->node_count;
+    ++this->node_type_counts[node_type];
+    return Read_OK;
+}
+
+
+void ExternalGraphReader::finishNodes() {
+    this->nodes->finish();
+}
+
+
+Read_Result ExternalGraphReader::readEdge(const std::string_view start, const std::string_view end, const Type_ID edge_type) {
+    Endpoint_Entry start_entry;
+    Endpoint_Entry end_entry;
+    if (!this->canonical_name(start, start_entry.name) || !this->canonical_name(end, end_entry.name)) {return Read_Invalid_ID;}
+    start_entry.half = 2 * this->edges_read;
+    end_entry.half = 2 * this->edges_read + 1;
+    start_entry.edge_type = edge_type;
+    end_entry.edge_type = edge_type;
+    this->endpoints->add(std::move(start_entry));
+    this->endpoints->add(std::move(end_entry));
+    ++this->edges_read;
+    return Read_OK;
+}
+
+
+m1_data ExternalGraphReader::process(std::map<std::string, std::string> meta_data, std::mt19937_64::result_type seed,
+    const Degree_Classes& degree_classes) {
+    std::cout << "\tResolving the edges on disk..." << std::flush;
+    this->endpoints->finish();
+
+    // Sorters that did not write any run keep their records in memory while they are merged. If they exceed the
+    //  budget together with the buffer of the halves, they are written to disk first.
+    const size_t halves_memory = std::min(this->memory_budget / 2, 2 * this->edges_read * sizeof(Edge_Half));
+    if (this->nodes->buffered_memory() + this->endpoints->buffered_memory() + halves_memory > this->memory_budget) {
+        this->nodes->release_memory();
+        this->endpoints->release_memory();
+    }
+
+    // Resolve every endpoint to its node by merging the sorted nodes and endpoints. Nodes are ranked in the order of
+    //  their names, the last definition of a node determines its type.
+    External_Sorter<Edge_Half> halves(this->run_directory / "halves", this->memory_budget / 2);
+    {
+        Node_Entry node;
+        Node_Entry next_node;
+        bool has_node = this->nodes->next(next_node);
+        std::uint64_t node_rank = 0;
+        Endpoint_Entry endpoint;
+        bool has_endpoint = this->endpoints->next(endpoint);
+        while (has_endpoint) {
+            // Advance to the last definition of the largest node that is not larger than the endpoint.
+            while (has_node && next_node.name <= endpoint.name) {
+                node = std::move(next_node);
+                has_node = this->nodes->next(next_node);
+                while (has_node && next_node.name == node.name) {
+                    node = std::move(next_node);
+                    has_node = this->nodes->next(next_node);
+                }
+                ++node_rank;
+            }
+            const bool found = node_rank > 0 && node.name == endpoint.name;
+
+            Edge_Half half;
+            half.half = endpoint.half;
+            half.edge_type = endpoint.edge_type;
+            if (found) {
+                half.node = node_rank - 1;
+                half.node_type = node.node_type;
+            }
+            halves.add(half);
+            has_endpoint = this->endpoints->next(endpoint);
+        }
+    }
+    this->nodes.reset();
+    this->endpoints.reset();
+    halves.finish();
+
+    // Pair the halves of every edge. Edges between known nodes are counted, their endpoints become units of degree.
+    Graph_Statistics statistics = {};
+    const size_t n_node_types = this->node_types.size();
+    const size_t n_edge_types = this->edge_types.size();
+    for (Type_ID n_type = 0; n_type < n_node_types; ++n_type) {
+        statistics.node_types.push_back(this->node_types.name(n_type));
+    }
+    for (Type_ID e_type = 0; e_type < n_edge_types; ++e_type) {
+        statistics.edge_types.push_back(this->edge_types.name(e_type));
+    }
+    statistics.node_type_counts = this->node_type_counts;
+    statistics.node_type_counts.resize(n_node_types, 0);
+    statistics.edge_type_counts.assign(n_edge_types, 0);
+    statistics.sbm_matrices.assign(n_edge_types, std::vector<Amount>(n_node_types * n_node_types, 0));
+
+    Amount unknown_edges = 0;
+    External_Sorter<Degree_Entry> degrees(this->run_directory / "degrees", this->memory_budget / 2);
+    {
+        Edge_Half start;
+        Edge_Half end;
+        while (halves.next(start) && halves.next(end)) {
+            if (start.node == Edge_Half::UNKNOWN_NODE || end.node == Edge_Half::UNKNOWN_NODE) {
+                ++unknown_edges;
+                continue;
+            }
+            ++statistics.edge_type_counts[start.edge_type];
+            ++statistics.sbm_matrices[start.edge_type][start.node_type * n_node_types + end.node_type];
+            degrees.add({start.node, start.edge_type, 0, start.node_type});
+            degrees.add({end.node, start.edge_type, 1, end.node_type});
+        }
+    }
+    degrees.finish();
+
+    // Count the degree of every node and add it to the distributions.
+    statistics.in_degrees.assign(n_node_types, std::vector<std::unordered_map<Degree, Amount> >(n_edge_types));
+    statistics.out_degrees.assign(n_node_types, std::vector<std::unordered_map<Degree, Amount> >(n_edge_types));
+    {
+        Degree_Entry current;
+        Degree_Entry entry;
+        bool has_entry = degrees.next(entry);
+        while (has_entry) {
+            current = entry;
+            Degree degree = 0;
+            while (has_entry && entry.same_degree(current)) {
+                ++degree;
+                has_entry = degrees.next(entry);
+            }
+            auto& distribution = current.direction == 0 ? statistics.out_degrees : statistics.in_degrees;
+            ++distribution[current.node_type][current.edge_type][degree];
+        }
+    }
+    std::cout << " Done." << std::endl;
+    if (unknown_edges > 0) {
+        std::cout << "\tSkipped " << unknown_edges << " edges with a start- or end-node that is not defined in the node-files." << std::endl;
+    }
+
+    return build_model(statistics, std::move(meta_data), seed, degree_classes);
+}
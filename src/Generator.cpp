@@ -5,9 +5,23 @@
 #include <tuple>
 #include <cstring>
 #include <thread>
-
-
-using Record = std::tuple<NodeID, NodeID, NodeID, NodeID, Probability>;
+#include <limits>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "../src/graphgenerator_format.h"
+
+
+// Integer-valued block (startX, endX, startY, endY, probability) used during generation. The width of the IDs is chosen
+//  per model: Models with less than ~4 billion nodes are generated with 32-bit IDs, which halves the size of the blocks.
+template <typename ID>
+using Block_Record = std::tuple<ID, ID, ID, ID, Probability>;
+using Record = Block_Record<NodeID>;
+using Narrow_NodeID = std::uint32_t;
 
 constexpr std::int8_t MAX_ALLOWED_TYPE_LENGTH = 64;
 constexpr std::int8_t MAX_NUM_DIGITS = 20;  // The highest number of digits for a 64bit uint in Base10.
@@ -16,65 +30,274 @@ constexpr std::int8_t MAX_OUT_STRING_LEN = MAX_ALLOWED_TYPE_LENGTH + 2*(MAX_NUM_
 constexpr std::int64_t MAX_BUFFER_SIZE = 1e5;
 constexpr std::int64_t MAX_BUFFER_SAFETY_MARGIN = 500;
 
+// Blocks with a higher expression-probability are generated by sampling the missing cells instead of the edges.
+constexpr Probability DENSE_BLOCK_THRESHOLD = 0.5f;
+
+// Blocks with a lower expression-probability or a larger number of cells are generated with 64-bit jumps drawn from
+//  double-precision uniforms. Single-precision floats only resolve 24 bits, which biases the jumps for tiny probabilities.
+constexpr Probability HIGH_PRECISION_PROBABILITY_THRESHOLD = 1.0f / (1 << 16);
+constexpr long double HIGH_PRECISION_CELL_THRESHOLD = 2147483648.0L;     // 2^31 cells
+
+// Largest NodeID for which the narrow IDs are used. The sparse path may overshoot the last row of a block by a single
+//  jump before it terminates, which is bounded by ~2^23 cells for p >= HIGH_PRECISION_PROBABILITY_THRESHOLD.
+constexpr NodeID MAX_NARROW_NODE_ID = std::numeric_limits<Narrow_NodeID>::max() - (1 << 24);
+
+// Don't bother with the threading-overhead for small work sizes.
+constexpr size_t MIN_BLOCKS_FOR_MULTITHREADING = 100;
 
-// Custom Int-to-(ASCII)-String function. Allows only unsigned 64-bit integers in base10.
-//     Safety-Checks removed, use at your own peril!
-// Adapted and optimized from: https://stackoverflow.com/a/12386915
-int unsafe_u64Int_to_str(char* sp, uint64_t value) {    // TODO: Tests needed..
-    char buffer[20]; // 20 Digits are sufficient for all 64bit unsigned integers.
-    char *tp = buffer;
+// Number of blocks read at once from streamed models.
+constexpr size_t STREAM_WINDOW_BLOCKS = 1 << 18;
 
-    do {
-        *tp++ = (value % 10)+'0';   // Radix is fixed at 10.
-        value /= 10;
-    } while (value);    // Do-While to correctly handle value=0
 
-    const int len = tp - buffer;
+// Settings for the worker-threads used in generation. Controlled by -Threads and -Affinity.
+struct Generation_Settings {
+    size_t n_threads = 0;       // 0: Use all but one of the available hardware threads.
+    bool pin_threads = false;   // Pin every worker to its own core. Its blocks and buffers are then allocated locally.
+};
 
-    while (tp > buffer) {
-        *sp++ = *--tp;
+// Number of worker-threads to use for the given settings. At least one.
+size_t resolve_thread_count(const Generation_Settings& settings) {
+    size_t n_threads = settings.n_threads;
+    if (n_threads == 0) {
+        n_threads = std::thread::hardware_concurrency() - 1;
     }
-    *sp = '\0';
+    return n_threads <= 1 ? 1 : n_threads;
+}
 
-    return len;
+// NUMA-node and package of a CPU, read from /sys/devices/system/cpu/cpuN. The node is the cpuN/nodeX directory,
+//  the package is topology/physical_package_id. Both are 0 if unknown, e.g. without NUMA-support in the kernel.
+std::pair<int, int> cpu_location(const int cpu) {
+    int node = 0;
+    int package = 0;
+#ifdef __linux__
+    const std::filesystem::path cpu_dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    std::error_code error;
+    for (const auto& entry: std::filesystem::directory_iterator(cpu_dir, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() > 4 && name.starts_with("node")
+            && std::all_of(name.begin() + 4, name.end(), [](const char c) {return c >= '0' && c <= '9';})) {
+            node = std::stoi(name.substr(4));
+            break;
+        }
+    }
+    std::ifstream package_file(cpu_dir / "topology" / "physical_package_id");
+    if (!(package_file >> package)) {package = 0;}
+#endif
+    return {node, package};
 }
 
-inline NodeID convert_start_of_block(const long double x) {
-    return static_cast<NodeID>(x) + 1;
+// Returns the IDs of all CPUs this process is allowed to run on. Empty if pinning is not supported on this platform.
+//  The CPUs are grouped by NUMA-node and package, so consecutive threads fill one node before moving to the next.
+std::vector<int> available_cpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        std::vector<std::tuple<int, int, int>> located_cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                const auto [node, package] = cpu_location(cpu);
+                located_cpus.emplace_back(node, package, cpu);
+            }
+        }
+        std::sort(located_cpus.begin(), located_cpus.end());
+        for (const auto& located_cpu: located_cpus) {cpus.push_back(std::get<2>(located_cpu));}
+    }
+#endif
+    return cpus;
 }
-inline NodeID convert_end_of_block(const long double x) {
-    return static_cast<NodeID>(x);
+
+// Pin the calling thread to the given CPU. Negative values leave the thread unpinned.
+void pin_current_thread(const int cpu) {
+    if (cpu < 0) {return;}
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
 }
 
-// Convert a given Edge-Record into the proper input-format.
+
+// The integer NodeIDs of a range at the given scale. They are taken from the product before it is rounded.
+inline NodeID convert_start_of_block(const ContinuousNodeID x, const long double scale) {
+    return scaled_integer_part(x, scale) + 1;
+}
+inline NodeID convert_end_of_block(const ContinuousNodeID x, const long double scale) {
+    return scaled_integer_part(x, scale);
+}
+
+// Convert the blocks of an edge-type into the proper input-format and append them to the given vector.
 //  This recovers the integer-valued NodeIDs for the start/end of a block from the real-valued representation used
-//  in the model. Reduce given probabilities to the interval [0,1].
-std::vector<Record> read_edge_block_data(const Edge_Record& data) {
-    if (data.edge_type.size() > MAX_ALLOWED_TYPE_LENGTH) {
-        throw std::runtime_error("The edge-type '" + data.edge_type +"' is larger than the allowed size of "
+//  in the model, at the given scale of the model. Reduce given probabilities to the interval [0,1].
+//  Returns the number of blocks whose probability exceeded 1 at the given scale (model-failures).
+template <typename ID, typename Blocks>
+Amount read_edge_block_data(const Edge_Type& edge_type, const Blocks& blocks, std::vector<Block_Record<ID>>& res,
+    const long double scale) {
+    if (edge_type.size() > MAX_ALLOWED_TYPE_LENGTH) {
+        throw std::runtime_error("The edge-type '" + edge_type +"' is larger than the allowed size of "
             + std::to_string(MAX_ALLOWED_TYPE_LENGTH) + " chars. Consider increasing MAX_ALLOWED_TYPE_LENGTH if necessary.");
     }
-    std::vector<Record> res = {};
-    res.reserve(data.blocks.size());
-    for (auto &[startX, endX, startY, endY, expression_probability]: data.blocks) {
+    res.reserve(res.size() + blocks.size());
+    Amount model_failures = 0;
+    for (auto &[startX, endX, startY, endY, expression_probability]: blocks) {
         // Restrict probabilities to the interval [0,1]. This is done here to allow for more accurate scaling of the model.
-        Probability prob = expression_probability;
-        const size_t s_X = convert_start_of_block(startX);
-        const size_t e_X = convert_end_of_block(endX);
-        const size_t s_Y = convert_start_of_block(startY);
-        const size_t e_Y = convert_end_of_block(endY);
+        Probability prob = scale == 1 ? expression_probability : static_cast<Probability>(expression_probability / scale);
+        const size_t s_X = convert_start_of_block(startX, scale);
+        const size_t e_X = convert_end_of_block(endX, scale);
+        const size_t s_Y = convert_start_of_block(startY, scale);
+        const size_t e_Y = convert_end_of_block(endY, scale);
 
         if (e_X < s_X || e_Y < s_Y) {continue;} // Can occur during downsizing due to strange rounding. TODO: Look into root cause!
-        if (prob > 1) {prob = 1;}
+        if (prob > 1) {
+            prob = 1;
+            ++model_failures;
+        }
+        // The width of the IDs of streamed models is chosen from their nodes alone.
+        if (std::max(e_X, e_Y) > std::numeric_limits<ID>::max() - (1 << 24)) {
+            throw std::runtime_error("A block of edge-type '" + edge_type + "' lies beyond the nodes of the model.");
+        }
+
+        res.emplace_back(static_cast<ID>(s_X), static_cast<ID>(e_X), static_cast<ID>(s_Y), static_cast<ID>(e_Y), prob);
+    }
+    return model_failures;
+}
+
+
+// Write a single edge to the output-buffer. When the buffer is close to being full, it is written to the output file and reset.
+inline void write_edge_to_buffer(char* buffer, char*& buffer_pos, const NodeID start, const NodeID end,
+    const std::string& e_type, std::ofstream& output, std::mutex& w_lock) {
+    // Use a customized conversion-function to write the Node-ID's to the output-buffer.
+    buffer_pos += unsafe_u64Int_to_str(buffer_pos, start);
+    *buffer_pos++ = '\t';
+    buffer_pos += unsafe_u64Int_to_str(buffer_pos, end);
+    *buffer_pos++ = '\t';
+    strcpy(buffer_pos, e_type.c_str());
+    buffer_pos += e_type.size();
+    *buffer_pos++ = '\n';
+
+    if (buffer_pos >= &buffer[MAX_BUFFER_SIZE-MAX_BUFFER_SAFETY_MARGIN-1]) [[unlikely]] {
+        w_lock.lock();
+        output.write(buffer, buffer_pos - buffer);
+        w_lock.unlock();
 
-        res.emplace_back(std::make_tuple(s_X, e_X, s_Y, e_Y, prob));
+        buffer_pos = &buffer[0];
+        buffer[0] = '\0';
     }
-    return res;
 }
 
 
-void multithread_generate_graph(const std::vector<Record>& data, const size_t workload_start, const size_t workload_end, std::ofstream& output,
-    const std::mt19937_64::result_type seed, const std::string& e_type, std::mutex& w_lock) {
+// Generate the edges of a dense block (p > DENSE_BLOCK_THRESHOLD). Instead of skipping over the edges, we skip over
+//  the cells that are NOT expressed, which are drawn from the geometric distribution of the complement (1-p).
+//  All cells in between are written sequentially. Blocks with p = 1 are fully enumerated without drawing at all.
+template <typename ID>
+void generate_dense_block(const Block_Record<ID>& block, char* buffer, char*& buffer_pos, std::mt19937_64& rdm_gen,
+    std::uniform_real_distribution<float>& uniform_f_distr, const std::string& e_type, std::ofstream& output, std::mutex& w_lock) {
+    const auto& [startX, endX, startY, endY, prob] = block;
+
+    if (prob >= 1.0f) {
+        for (ID idx_y = startY; idx_y <= endY; ++idx_y) {
+            for (ID idx_x = startX; idx_x <= endX; ++idx_x) {
+                write_edge_to_buffer(buffer, buffer_pos, idx_x, idx_y, e_type, output, w_lock);
+            }
+        }
+        return;
+    }
+
+    // Same method as for sparse blocks, the probability of a missing cell is (1-p), so ln(1-(1-p)) = ln(p).
+    const float complement_denominator = (1 / std::log(prob)) * 0.69314718f;
+    ID idx_x = startX;
+    ID idx_y = startY;
+    while (idx_y <= endY) {
+        // Number of cells up to and including the next missing cell. Always at least 1.
+        Amount jump_distance = static_cast<Amount>(std::ceil(std::log2(uniform_f_distr(rdm_gen)) * complement_denominator));
+        if (jump_distance < 1) {jump_distance = 1;}
+
+        // Write all expressed cells before the next missing cell.
+        for (Amount i = 1; i < jump_distance; ++i) {
+            write_edge_to_buffer(buffer, buffer_pos, idx_x, idx_y, e_type, output, w_lock);
+            if (idx_x == endX) {
+                idx_x = startX;
+                if (++idx_y > endY) [[unlikely]] {return;}
+            } else {
+                ++idx_x;
+            }
+        }
+
+        // Skip the missing cell.
+        if (idx_x == endX) {
+            idx_x = startX;
+            ++idx_y;
+        } else {
+            ++idx_x;
+        }
+    }
+}
+
+
+// Check if a block needs to be generated with the high-precision path. This is the case for very small probabilities
+//  and for blocks with more cells than a single jump of the default path can safely cover. Both typically occur after upscaling.
+template <typename ID>
+inline bool requires_high_precision(const Block_Record<ID>& block) {
+    const auto& [startX, endX, startY, endY, prob] = block;
+    const long double cells = static_cast<long double>(endX - startX + 1) * static_cast<long double>(endY - startY + 1);
+    return prob < HIGH_PRECISION_PROBABILITY_THRESHOLD || cells >= HIGH_PRECISION_CELL_THRESHOLD;
+}
+
+
+// Generate the edges of a sparse block with 64-bit skip-arithmetic and 53-bit uniforms.
+//  Jumps that reach beyond the end of the block are detected in floating point before they are converted to integers.
+//  The position is always tracked in 64 bits, independent of the width of the IDs.
+template <typename ID>
+void generate_high_precision_block(const Block_Record<ID>& block, char* buffer, char*& buffer_pos, std::mt19937_64& rdm_gen,
+    const std::string& e_type, std::ofstream& output, std::mutex& w_lock) {
+    const auto& [startX, endX, startY, endY, prob] = block;
+
+    // log1p keeps the full precision of ln(1-p) for tiny p.
+    const double devroye_denominator = 1 / std::log1p(-static_cast<double>(prob));
+    const Amount len_x = static_cast<Amount>(endX - startX) + 1;
+
+    // Start on the last cell before the block, so the first jump may land on the first cell.
+    Amount offset_x = len_x - 1;
+    NodeID idx_y = static_cast<NodeID>(startY) - 1;
+    while (true) {
+        // Uniform from (0,1) with 53 bits of resolution. The offset of half a step excludes 0.
+        const double uniform = (static_cast<double>(rdm_gen() >> 11) + 0.5) * 0x1.0p-53;
+        const double jump_distance = std::ceil(std::log(uniform) * devroye_denominator);
+
+        // Remaining cells after the current position. Compare in floating point to avoid any integer overflow.
+        const long double remaining = static_cast<long double>(endY - idx_y) * len_x + static_cast<long double>(len_x - 1 - offset_x);
+        if (jump_distance > remaining) [[unlikely]]
+            {break;}
+
+        const Amount jump = jump_distance < 1 ? 1 : static_cast<Amount>(jump_distance);
+        offset_x += jump % len_x;
+        idx_y += jump / len_x;
+        if (offset_x >= len_x) {
+            offset_x -= len_x;
+            ++idx_y;
+        }
+
+        write_edge_to_buffer(buffer, buffer_pos, startX+offset_x, idx_y, e_type, output, w_lock);
+    }
+}
+
+
+template <typename ID>
+void multithread_generate_graph(const std::vector<Block_Record<ID>>& shared_data, size_t workload_start, size_t workload_end, std::ofstream& output,
+    const std::mt19937_64::result_type seed, const std::string& e_type, std::mutex& w_lock, const int cpu = -1) {
+
+    // A pinned worker copies its share of the blocks after pinning. By first-touch, the copy is then allocated on the
+    //  NUMA-node of the worker, instead of every worker reading from the node the shared table was allocated on.
+    pin_current_thread(cpu);
+    std::vector<Block_Record<ID>> local_data;
+    if (cpu >= 0) {
+        local_data.assign(shared_data.begin() + static_cast<long>(workload_start), shared_data.begin() + static_cast<long>(workload_end) + 1);
+        workload_end -= workload_start;
+        workload_start = 0;
+    }
+    const std::vector<Block_Record<ID>>& data = cpu >= 0 ? local_data : shared_data;
 
     char buffer[MAX_BUFFER_SIZE] = "";
     char* buffer_pos = &buffer[0];
@@ -84,19 +307,33 @@ void multithread_generate_graph(const std::vector<Record>& data, const size_t wo
 
     for (size_t idx = workload_start; idx <= workload_end; ++idx) {
         const auto& [startX, endX, startY, endY, prob] = data[idx];
+
+        // Almost every cell of a dense block is an edge, skipping over the missing cells is much cheaper.
+        if (prob > DENSE_BLOCK_THRESHOLD) {
+            generate_dense_block(data[idx], buffer, buffer_pos, rdm_gen, uniform_f_distr, e_type, output, w_lock);
+            continue;
+        }
+
+        // Very sparse or very large blocks (i.e. after upscaling) need more precision than single-precision floats provide.
+        if (requires_high_precision(data[idx])) [[unlikely]] {
+            generate_high_precision_block(data[idx], buffer, buffer_pos, rdm_gen, e_type, output, w_lock);
+            continue;
+        }
+
         // Improved drawing from the geometric distribution using the method from Luc Devroye.
         //     L. Devroye "Non-Uniform Random Variate Generation", Springer Verlag (1986), p.499 ff
         // As the denominator ln(1-p) is constant for given p, we precompute 1 / ln(1-p) for the block.
         // We later calculate log2, which we then need to multiply with ln(2) = 0.69314718 to approximate the nat. logarithm.
         const float devroye_denominator = (1 / std::log(1-prob)) * 0.69314718f;
 
-        // Pick edges within the block.
-        const Amount len_x = (endX - startX) + 1;
-        Amount offset_x = 0;
-        NodeID idx_y = startY;
+        // Pick edges within the block. We start on the last cell before the block, so the first jump may land on the first cell.
+        //  The block has less than 2^31 cells and p is bounded from below here, so the jumps always fit into the integer range.
+        const ID len_x = (endX - startX) + 1;
+        ID offset_x = len_x - 1;
+        ID idx_y = startY - 1;
         while (true) {
-            const Amount jump_distance = 1 + static_cast<int>(std::ceil(std::log2(uniform_f_distr(rdm_gen)) * devroye_denominator));
-            const Amount next_offset = offset_x + jump_distance;
+            const Amount jump_distance = static_cast<Amount>(std::ceil(std::log2(uniform_f_distr(rdm_gen)) * devroye_denominator));
+            const ID next_offset = offset_x + static_cast<ID>(jump_distance < 1 ? 1 : jump_distance);
 
             offset_x = next_offset % len_x;
             idx_y += next_offset / len_x;
@@ -104,24 +341,7 @@ void multithread_generate_graph(const std::vector<Record>& data, const size_t wo
             if (idx_y > endY) [[unlikely]]
                 {break;}
 
-            // Use a customized conversion-function to write the Node-ID's to the output-buffer.
-            buffer_pos += unsafe_u64Int_to_str(buffer_pos, startX+offset_x);
-            *buffer_pos++ = '\t';
-            buffer_pos += unsafe_u64Int_to_str(buffer_pos, idx_y);
-            *buffer_pos++ = '\t';
-            strcpy(buffer_pos, e_type.c_str());
-            buffer_pos += e_type.size();
-            *buffer_pos++ = '\n';
-
-            // When the buffer is close to being full, write it to the output buffer and reset it.
-            if (buffer_pos >= &buffer[MAX_BUFFER_SIZE-MAX_BUFFER_SAFETY_MARGIN-1]) [[unlikely]] {
-                w_lock.lock();
-                output.write(buffer, buffer_pos - buffer);
-                w_lock.unlock();
-
-                buffer_pos = &buffer[0];
-                buffer[0] = '\0';
-            }
+            write_edge_to_buffer(buffer, buffer_pos, startX+offset_x, idx_y, e_type, output, w_lock);
         }
     }
 
@@ -133,51 +353,97 @@ void multithread_generate_graph(const std::vector<Record>& data, const size_t wo
     }
 }
 
-void generate_graph(const std::string& node_file_name, const std::string& edge_file_name,
-    const m1_data& data, const std::mt19937_64::result_type seed) {
-    // Try to open the output files. We keep the size of the files after opening to calculate the amount of data written later.
-    std::ofstream node_file;
-    node_file.open(node_file_name);
-    if (!node_file.is_open()) {
-        throw std::runtime_error("Could not open output file: " + node_file_name);
+// Highest integer NodeID used by the nodes at the given scale.
+NodeID max_node_id(const std::vector<Node_Record>& nodes, const long double scale) {
+    ContinuousNodeID max_id = 0;
+    for (const auto& node: nodes) {
+        max_id = std::max(max_id, node.endID);
     }
-    const size_t node_bytes_at_start = node_file.tellp();
+    return convert_end_of_block(max_id, scale);
+}
 
-    std::ofstream edge_file;
-    edge_file.open(edge_file_name, std::ios::trunc | std::ios::binary);
-    if (!edge_file.is_open()) {
-        throw std::runtime_error("Could not open output file: " + edge_file_name);
+// Highest integer NodeID used anywhere in the model, either by the nodes or by any edge-block.
+NodeID max_node_id(const m1_data& data) {
+    ContinuousNodeID max_id = 0;
+    for (const auto& record: data.edges) {
+        for (const auto& block: record.blocks) {
+            max_id = std::max({max_id, block.endX, block.endY});
+        }
     }
-    const size_t edge_bytes_at_start = edge_file.tellp();
+    return std::max(max_node_id(data.nodes, data.scale), convert_end_of_block(max_id, data.scale));
+}
 
 
-    // Write the node-file: The ID's of all blocks are filled out.
-    for (auto &[startID, endID, node_type] : data.nodes) {
-        const Node_Type n_type = node_type;
-        NodeID start = convert_start_of_block(startID);
-        NodeID end = convert_end_of_block(endID);
-
-        std::string opt_string;
-        opt_string.reserve(MAX_OUT_STRING_LEN);
-        // #pragma omp parallel for private(opt_string)
-        for (NodeID i = start; i <= end; ++i) {
-            opt_string = "";
-            opt_string.append(std::to_string(i));
-            opt_string.push_back('\t');
-            opt_string.append(n_type);
-            opt_string.push_back('\n');
-            node_file << opt_string;
+// CPUs to pin the worker-threads to. Empty if the threads are not pinned.
+std::vector<int> resolve_cpus(const Generation_Settings& settings) {
+    const std::vector<int> cpus = settings.pin_threads ? available_cpus() : std::vector<int>{};
+    if (settings.pin_threads && cpus.empty()) {
+        std::cerr << "\t\tWarning: Pinning threads is not supported on this platform. Continuing without affinity." << std::endl;
+    }
+    return cpus;
+}
+
+// Distributes the blocks evenly over the worker-threads and starts them. The caller joins the returned threads.
+//  Small work sizes are generated by a single worker. It runs on the calling thread, unless the threads are pinned:
+//  Then a single worker is started on the first CPU, so the calling thread keeps its affinity.
+template <typename ID>
+std::vector<std::thread> start_block_workers(const std::vector<Block_Record<ID>>& blocks, const std::string& e_type,
+    std::ofstream& edge_file, std::mt19937_64& rdm_gen, const size_t n_threads, const std::vector<int>& cpus,
+    std::mutex& write_lock) {
+    std::vector<std::thread> threads;
+    if (blocks.empty()) {return threads;}
+
+    // Don't bother with the threading-overhead for small work sizes.
+    if (n_threads == 1 || blocks.size() < MIN_BLOCKS_FOR_MULTITHREADING) {
+        if (cpus.empty()) {
+            multithread_generate_graph<ID>(blocks, 0, blocks.size()-1, edge_file, rdm_gen(), e_type, write_lock);
+        } else {
+            threads.emplace_back(
+                std::thread(multithread_generate_graph<ID>,
+                    std::cref(blocks), 0, blocks.size()-1, std::ref(edge_file), rdm_gen(),
+                    std::cref(e_type), std::ref(write_lock), cpus[0]
+                ));
         }
+        return threads;
     }
-    std::cout << "\t\tWrote " << static_cast<size_t>(node_file.tellp()) - node_bytes_at_start << " bytes into the provided node-file." << std:: endl;
-    node_file.close();
 
+    for (size_t thread_no = 0; thread_no < n_threads; ++thread_no) {
+        const size_t idx_start = blocks.size() * thread_no / n_threads;
+        const size_t idx_next = blocks.size() * (thread_no + 1) / n_threads;
+        if (idx_next == idx_start) {continue;}   // More threads than blocks.
+        const size_t idx_end = idx_next - 1;
+        // The CPUs are ordered by node, so neighbouring threads share a node as long as it has free CPUs.
+        const int cpu = cpus.empty() ? -1 : cpus[thread_no % cpus.size()];
+
+        threads.emplace_back(
+            std::thread(multithread_generate_graph<ID>,
+                std::cref(blocks), idx_start, idx_end, std::ref(edge_file), rdm_gen(),
+                std::cref(e_type), std::ref(write_lock), cpu
+            ));
+    }
+    return threads;
+}
+
+
+// Generate the edges for all edge-types of the model and write them to the given file.
+//  ID is the integer type used for all NodeIDs and offsets within the blocks.
+template <typename ID>
+void generate_edges(std::ofstream& edge_file, const m1_data& data, const std::mt19937_64::result_type seed,
+    const Generation_Settings& settings) {
     // Convert Edge-Block-Data from the model into the preferred form for construction.
-    std::vector<std::pair<Edge_Type, std::vector<Record>>> block_data = {};
+    std::vector<std::pair<Edge_Type, std::vector<Block_Record<ID>>>> block_data = {};
     block_data.reserve(data.edges.size());
 
+    Amount model_failures = 0;
+    Amount total_blocks = 0;
     for (const auto &e: data.edges) {
-        block_data.emplace_back(std::make_pair(e.edge_type, read_edge_block_data(e)));
+        block_data.emplace_back(e.edge_type, std::vector<Block_Record<ID>>());
+        model_failures += read_edge_block_data<ID>(e.edge_type, e.blocks, block_data.back().second, data.scale);
+        total_blocks += e.blocks.size();
+    }
+    if (data.scale != 1 && model_failures > 0) {
+        std::cerr << "\t\t" << model_failures << " (" << model_failures / (total_blocks / static_cast<long double>(100))
+            << "%) model-failures (block-probability > 1.0) at the current scale." << std::endl;
     }
 
 
@@ -185,43 +451,106 @@ void generate_graph(const std::string& node_file_name, const std::string& edge_f
     // TODO: Optionally use ankerl::nanobench::Rng (Uses the somewhat dodgy RomuDuoJr-Algorithm.)
     // TODO: Verify accurate seeding (including within threads!)
     std::mt19937_64 rdm_gen(seed);
-    const auto start = std::chrono::high_resolution_clock::now();
 
-    for (const auto& [e_type, block] : block_data) {
+    const size_t n_threads = resolve_thread_count(settings);
+    const std::vector<int> cpus = resolve_cpus(settings);
 
-        size_t n_threads = std::thread::hardware_concurrency() - 1;
-        if (n_threads <= 1) {n_threads = 1;}
+    for (const auto& [e_type, block] : block_data) {
+        std::mutex write_lock;
+        std::vector<std::thread> threads = start_block_workers<ID>(block, e_type, edge_file, rdm_gen, n_threads, cpus, write_lock);
 
-        size_t workload_size = block.size() / n_threads;
-        size_t overflow_workload_size = workload_size % n_threads;
+        // Wait for all threads to complete before advancing to the next edgetype
+        for (auto& thread: threads) {thread.join();}
+    }
+}
 
-        std::vector<std::thread> threads;
-        std::mutex write_lock;
 
-        // Don't bother with the threading-overhead for small work sizes.
-        if (block.size() < 100) {
-            multithread_generate_graph(block, 0, block.size()-1, edge_file, rdm_gen(), e_type, write_lock);
-            continue;
+// Generate the edges of a streamed model. The blocks are read in windows of STREAM_WINDOW_BLOCKS, the next window is
+//  read while the workers generate the current one. At most two windows are held in memory.
+template <typename ID>
+void generate_streamed_edges(std::ofstream& edge_file, M1_Block_Stream& stream, const long double scale,
+    const std::mt19937_64::result_type seed, const Generation_Settings& settings) {
+    std::mt19937_64 rdm_gen(seed);
+    const size_t n_threads = resolve_thread_count(settings);
+    const std::vector<int> cpus = resolve_cpus(settings);
+
+    std::vector<Edge_Block> window;
+    auto read_window = [&](std::string& e_type, std::vector<Block_Record<ID>>& blocks) {
+        blocks.clear();
+        while (blocks.empty()) {
+            if (!stream.next(e_type, window, STREAM_WINDOW_BLOCKS)) {return false;}
+            read_edge_block_data<ID>(e_type, window, blocks, scale);
         }
+        return true;
+    };
+
+    std::mutex write_lock;
+    std::string e_type, next_e_type;
+    std::vector<Block_Record<ID>> blocks, next_blocks;
+    bool has_window = read_window(e_type, blocks);
+    while (has_window) {
+        std::vector<std::thread> threads = start_block_workers<ID>(blocks, e_type, edge_file, rdm_gen, n_threads, cpus, write_lock);
+        has_window = read_window(next_e_type, next_blocks);
+        for (auto& thread: threads) {thread.join();}
+        blocks.swap(next_blocks);
+        e_type.swap(next_e_type);
+    }
+}
 
-        // Distribute the blocks over all available threads.
-        size_t idx_start = 0;
-        size_t idx_end = overflow_workload_size + workload_size - 1;
-        for (size_t thread_no = 0; thread_no < n_threads; ++thread_no) {
 
-            threads.emplace_back(
-                std::thread(multithread_generate_graph,
-                    std::cref(block), idx_start, idx_end, std::ref(edge_file), rdm_gen(),
-                    std::cref(e_type), std::ref(write_lock)
-                ));
-            idx_start = idx_end+1;
-            idx_end = idx_start + workload_size;
-            if (idx_end > block.size()) {idx_end = block.size()-1;}
+// Write the node-file and the edge-file of a new graph. The nodes are written at the given scale, the edges are
+//  written by generate(edge_file).
+template <typename Function>
+void write_graph(const std::string& node_file_name, const std::string& edge_file_name,
+    const std::vector<Node_Record>& nodes, const long double scale, const Function& generate) {
+    // Try to open the output files. We keep the size of the files after opening to calculate the amount of data written later.
+    std::ofstream node_file;
+    node_file.open(node_file_name);
+    if (!node_file.is_open()) {
+        throw std::runtime_error("Could not open output file: " + node_file_name);
+    }
+    const size_t node_bytes_at_start = node_file.tellp();
+
+    std::ofstream edge_file;
+    edge_file.open(edge_file_name, std::ios::trunc | std::ios::binary);
+    if (!edge_file.is_open()) {
+        throw std::runtime_error("Could not open output file: " + edge_file_name);
+    }
+    const size_t edge_bytes_at_start = edge_file.tellp();
+
+
+    // Write the node-file: The ID's of all blocks are filled out.
+    char buffer[MAX_BUFFER_SIZE] = "";
+    char* buffer_pos = &buffer[0];
+    for (auto &[startID, endID, node_type] : nodes) {
+        // Node-Types are not restricted in length, so the buffer is flushed whenever the next line might not fit.
+        const size_t max_line_length = node_type.size() + MAX_NUM_DIGITS + 2;
+        if (max_line_length >= MAX_BUFFER_SIZE) {
+            throw std::runtime_error("The node-type '" + node_type.substr(0, MAX_ALLOWED_TYPE_LENGTH) + "...' is larger than the output-buffer.");
         }
+        const char* buffer_limit = &buffer[MAX_BUFFER_SIZE - max_line_length];
+        NodeID start = convert_start_of_block(startID, scale);
+        NodeID end = convert_end_of_block(endID, scale);
 
-        // Wait for all threads to complete before advancing to the next edgetype
-        for (auto& thread: threads) {thread.join();}
+        for (NodeID i = start; i <= end; ++i) {
+            if (buffer_pos >= buffer_limit) [[unlikely]] {
+                node_file.write(buffer, buffer_pos - buffer);
+                buffer_pos = &buffer[0];
+            }
+
+            buffer_pos += unsafe_u64Int_to_str(buffer_pos, i);
+            *buffer_pos++ = '\t';
+            memcpy(buffer_pos, node_type.data(), node_type.size());
+            buffer_pos += node_type.size();
+            *buffer_pos++ = '\n';
+        }
     }
+    node_file.write(buffer, buffer_pos - buffer);
+    std::cout << "\t\tWrote " << static_cast<size_t>(node_file.tellp()) - node_bytes_at_start << " bytes into the provided node-file." << std:: endl;
+    node_file.close();
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    generate(edge_file);
 
     size_t bytes_written = static_cast<size_t>(edge_file.tellp()) - edge_bytes_at_start;
     edge_file.close();
@@ -232,3 +561,31 @@ void generate_graph(const std::string& node_file_name, const std::string& edge_f
     std::cout << "\t\tWrote " << bytes_written / 1.0e9L << " GB into the provided edge-file in " << duration.count() / 1000.0L << " seconds. \n";
     std::cout << "\t\tGenerated with a rate of " << (bytes_written / 1.0e9L) / (duration.count() / 1000.0L) << " GB/s. \n";
 }
+
+
+void generate_graph(const std::string& node_file_name, const std::string& edge_file_name,
+    const m1_data& data, const std::mt19937_64::result_type seed, const Generation_Settings& settings = {}) {
+    write_graph(node_file_name, edge_file_name, data.nodes, data.scale, [&](std::ofstream& edge_file) {
+        // Narrow IDs are only used if every block of the model fits into their range.
+        if (max_node_id(data) <= MAX_NARROW_NODE_ID) {
+            generate_edges<Narrow_NodeID>(edge_file, data, seed, settings);
+        } else {
+            generate_edges<NodeID>(edge_file, data, seed, settings);
+        }
+    });
+}
+
+// Generate a graph from a model-file, whose blocks are read while generating. The header holds the meta-data, the
+//  nodes and the scale of the model, which is applied to the blocks as they are read.
+void generate_streamed_graph(const std::string& node_file_name, const std::string& edge_file_name,
+    const m1_data& header, const std::string& model_file_name,
+    const std::mt19937_64::result_type seed, const Generation_Settings& settings = {}) {
+    M1_Block_Stream stream(model_file_name);
+    write_graph(node_file_name, edge_file_name, header.nodes, header.scale, [&](std::ofstream& edge_file) {
+        if (max_node_id(header.nodes, header.scale) <= MAX_NARROW_NODE_ID) {
+            generate_streamed_edges<Narrow_NodeID>(edge_file, stream, header.scale, seed, settings);
+        } else {
+            generate_streamed_edges<NodeID>(edge_file, stream, header.scale, seed, settings);
+        }
+    });
+}
@@ -1,8 +1,16 @@
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <span>
 #include <unordered_map>
 #include <random>
 #include <string>
-#include <unordered_set>
+#include <string_view>
+#include <thread>
 #include "../src/graphgenerator_types.h"
+#include "../src/graphgenerator_intern.h"
+#include "../src/graphgenerator_radix.h"
+#include "../src/graphgenerator_parallel.h"
 
 
 struct Edge_Type_Container {
@@ -18,118 +26,486 @@ struct Edge_Type_Container {
 struct Node_Type_Container {
     Amount node_count = 0;
     Node_Type node_type;
-    std::unordered_map<Edge_Type, Edge_Type_Container> edge_data;
+    size_t type_index = 0;  // Index of the node-type in the Graph_Statistics.
+    std::map<Edge_Type, Edge_Type_Container> edge_data;
     [[nodiscard]] bool has_edge_type(const Edge_Type &t) const {return edge_data.contains(t);}
 };
 
 
+// Statistics of a read graph, from which the model is built. Node- and edge-types are referenced by their index.
+struct Graph_Statistics {
+    std::vector<Node_Type> node_types;
+    std::vector<Amount> node_type_counts;
+    std::vector<Edge_Type> edge_types;
+    std::vector<Amount> edge_type_counts;
+
+    // Number of Type-Type-Transitions for each Edge-Type, as a flat matrix [start_type * node_types.size() + end_type].
+    std::vector<std::vector<Amount> > sbm_matrices;
+
+    // Number of nodes with each (non-zero) degree, indexed by [node_type][edge_type].
+    std::vector<std::vector<std::unordered_map<Degree, Amount> > > in_degrees;
+    std::vector<std::vector<std::unordered_map<Degree, Amount> > > out_degrees;
+};
+
+// Builds the model from the statistics of a graph. Shared by all readers.
+m1_data build_model(const Graph_Statistics& statistics, std::map<std::string, std::string> meta_data,
+    std::mt19937_64::result_type seed, const Degree_Classes& degree_classes);
+
+
+// Outcome of reading a single node or edge.
+enum Read_Result {
+    Read_OK,
+    Read_Invalid_ID,    // A node-ID is not accepted by the Node_ID_Mode.
+    Read_Unknown_Node   // The edge references a node that was never read.
+};
+
+
 class GenericGraphReader {
 public:
-    GenericGraphReader();
+    explicit GenericGraphReader(Node_ID_Mode id_mode = Node_ID_Mode::Auto,
+        Degree_Aggregation aggregation_ = Degree_Aggregation::Records);
+    // Partial readers are used to read parts of an edge-file in parallel. They look up the nodes in the given reader
+    //  and count the degrees of its nodes directly into its records, or collect the endpoints if the given reader
+    //  sorts them. The nodes of the given reader must not be modified while they exist. Partial readers are merged into
+    //  it afterwards.
+    explicit GenericGraphReader(GenericGraphReader* node_source_);
 
-    void readNode(const std::string& node, const Node_Type &node_type);
-    void readEdge(const std::string& start, const std::string& end, const Edge_Type &edge_type);
+    // Files are read in parallel into partial readers.
+    static constexpr bool SUPPORTS_PARTIALS = true;
 
-    m1_data process(std::map<std::string, std::string> meta_data, std::mt19937_64::result_type seed);
+    // Types are interned into IDs of this reader before reading nodes or edges. A composite type is given by the
+    //  columns it is composed of, which are joined by underscores.
+    Type_ID internNodeType(std::span<const std::string_view> columns, std::span<const size_t> indices);
+    Type_ID internEdgeType(std::span<const std::string_view> columns, std::span<const size_t> indices);
 
-    Amount node_count;
-    std::unordered_map<Edge_Type, Amount> edge_count;
+    // Edges are only read between nodes that were read before. Nothing is counted for lines that are not read.
+    Read_Result readNode(std::string_view node, Type_ID node_type);
+    Read_Result readEdge(std::string_view start, std::string_view end, Type_ID edge_type);
+
+    // Called once all nodes are read. Prepares the lookups of the nodes for the edges.
+    void finishNodes();
+
+    [[nodiscard]] Node_ID_Mode nodeIDMode() const {return this->node_ids.id_mode();}
+    [[nodiscard]] Degree_Aggregation degreeAggregation() const {return this->aggregation;}
+
+    // Adds all statistics of the given partial reader to this reader. Nodes in the given reader overwrite nodes with
+    //  the same name. The given reader is left in an unspecified state.
+    void merge(GenericGraphReader& partial);
 
-    // Number of Type-Type-Transitions for each Edge-Type
-    std::unordered_map<Edge_Type, std::map<std::pair<Node_Type, Node_Type>, Amount> > sbm_matrix;
+    m1_data process(std::map<std::string, std::string> meta_data, std::mt19937_64::result_type seed,
+        const Degree_Classes& degree_classes = {});
 
-    // Count the number of occurrences for every Type/Color to calculate a distribution in the end.
-    std::unordered_map<Node_Type, Amount> node_types;
-    std::unordered_set<Edge_Type> edge_colors;
+    Amount node_count;
 
 private:
-    // Save the nodeType for every read node. Needed later to map the edges to the correct node-type
-    std::unordered_map<std::string, Node_Type> nodes_to_types;
+    // Location of the out- and in-degrees of one edge-type: The degrees of node i are out[i*stride] and in[i*stride].
+    struct Degree_Slots {
+        Degree* out = nullptr;
+        Degree* in = nullptr;
+        size_t stride = 0;
+    };
+
+    [[nodiscard]] size_t record_stride() const {return 1 + 2 * this->record_slots;}
+    [[nodiscard]] Type_ID type_of(const Dense_NodeID id) const {
+        return static_cast<Type_ID>(this->node_records[id * this->record_stride()]);
+    }
+
+    // Grows the per-edge-type data to all interned edge-types. Readers without partial readers may widen their
+    //  records for new edge-types.
+    void add_edge_types(bool allow_widening);
+
+    // Re-lays out the records with degree-slots for the given number of edge-types.
+    void widen_records(size_t slots);
 
-    // Count Incoming/Outgoing Edges for every Node
-    std::unordered_map<Edge_Type, std::map<std::string, Degree> > in_degrees;
-    std::unordered_map<Edge_Type, std::map<std::string, Degree> > out_degrees;
+    // Lays out the SBM-Matrices for the given number of node-types, keeping their counts.
+    void resize_sbm_matrices(size_t dimension);
+
+    Degree_Slots degree_slots(Type_ID edge_type);
+
+    // Degree-slots of the given edge-type in the node_source, shared by all partial readers.
+    Degree_Slots shared_degree_slots(Type_ID edge_type);
+
+    // Counts the degrees from the sorted endpoints into the distributions of the statistics.
+    void count_sorted_degrees(Graph_Statistics& statistics);
+
+    // Endpoints are collected as keys of the edge-type in the upper and the dense node-ID in the lower 32 bits.
+    static std::uint64_t endpoint_key(const Type_ID edge_type, const Dense_NodeID id) {
+        return (static_cast<std::uint64_t>(edge_type) << 32) | id;
+    }
+
+    Degree_Aggregation aggregation = Degree_Aggregation::Records;
+    GenericGraphReader* node_source = nullptr;
+
+    // Every read node is interned into a dense ID, which indexes its record. A record holds the node-type, followed by
+    //  the out- and in-degree of every edge-type with a slot in the records. A lookup of a node thus touches a single
+    //  record. Edge-types that were added while partial readers existed have their degrees in separate arrays.
+    Node_Index node_ids;
+    std::vector<Degree> node_records;
+    size_t record_slots = 1;
+    std::vector<std::pair<std::vector<Degree>, std::vector<Degree> > > overflow_degrees;
+
+    // With Degree_Aggregation::Sort, the records hold only the node-type. The start- and end-nodes of all edges are
+    //  collected instead and sorted once all edges are read.
+    std::vector<std::uint64_t> start_keys;
+    std::vector<std::uint64_t> end_keys;
+
+    // Count the number of occurrences for every Type/Color to calculate a distribution in the end. Indexed by the Type_IDs.
+    Type_Table node_types;
+    Type_Table edge_types;
+    std::vector<Amount> node_type_counts;
+    std::vector<Amount> edge_type_counts;
+
+    // Number of Type-Type-Transitions for each Edge-Type, as a flat matrix [start_type * sbm_dimension + end_type].
+    //  Partial edge-readers count the transitions of the node-types of the node_source.
+    std::vector<std::vector<Amount> > sbm_matrices;
+    size_t sbm_dimension = 0;
+
+    // Partial edge-readers cache the degree-slots of the node_source. Adding edge-types to it requires the lock.
+    std::vector<Degree_Slots> shared_degree_cache;
+    std::mutex shared_degree_lock;
 };
 
-GenericGraphReader::GenericGraphReader(): node_count(0) {}
+GenericGraphReader::GenericGraphReader(const Node_ID_Mode id_mode, const Degree_Aggregation aggregation_): node_count(0),
+    aggregation(aggregation_), node_ids(id_mode), record_slots(aggregation_ == Degree_Aggregation::Sort ? 0 : 1) {}
 
-void GenericGraphReader::readNode(const std::string& node, const Node_Type &node_type) {
-    ++this->node_count;
+GenericGraphReader::GenericGraphReader(GenericGraphReader* node_source_): node_count(0),
+    aggregation(node_source_->aggregation), node_source(node_source_), node_ids(node_source_->node_ids.id_mode()),
+    sbm_dimension(node_source_->node_types.size()) {}
 
-    // Increase the count of the node-color
-    ++this->node_types[node_type];
+Type_ID GenericGraphReader::internNodeType(const std::span<const std::string_view> columns, const std::span<const size_t> indices) {
+    const Type_ID id = this->node_types.intern(columns, indices);
+    if (id >= this->node_type_counts.size()) {
+        this->node_type_counts.resize(id + 1, 0);
+        this->resize_sbm_matrices(this->node_types.size());
+    }
+    return id;
+}
 
-    // Remember this node for future lookups
-    this->nodes_to_types[node] = node_type;
+Type_ID GenericGraphReader::internEdgeType(const std::span<const std::string_view> columns, const std::span<const size_t> indices) {
+    const Type_ID id = this->edge_types.intern(columns, indices);
+    if (id >= this->edge_type_counts.size()) {this->add_edge_types(true);}
+    return id;
 }
 
+void GenericGraphReader::add_edge_types(const bool allow_widening) {
+    const size_t n_edge_types = this->edge_types.size();
+    this->edge_type_counts.resize(n_edge_types, 0);
+    this->sbm_matrices.resize(n_edge_types, std::vector<Amount>(this->sbm_dimension * this->sbm_dimension, 0));
+    if (this->aggregation == Degree_Aggregation::Sort) {return;}
+    if (this->node_source != nullptr) {
+        this->shared_degree_cache.resize(n_edge_types);
+        return;
+    }
 
-void GenericGraphReader::readEdge(const std::string& start, const std::string& end, const Edge_Type &edge_type) {
-    ++this->edge_count[edge_type];
+    // Edge-types get a slot in the records as long as all previous edge-types have one.
+    if (allow_widening && this->overflow_degrees.empty() && n_edge_types > this->record_slots) {
+        this->widen_records(n_edge_types);
+    }
+    const size_t n_nodes = this->node_ids.size();
+    while (this->record_slots + this->overflow_degrees.size() < n_edge_types) {
+        this->overflow_degrees.emplace_back(std::vector<Degree>(n_nodes, 0), std::vector<Degree>(n_nodes, 0));
+    }
+}
 
-    // Increase the entry in the SBM-Matrix
-    Node_Type type_start = this->nodes_to_types[start];
-    Node_Type type_end = this->nodes_to_types[end];
-    ++this->sbm_matrix[edge_type][std::make_pair(type_start, type_end)];
+void GenericGraphReader::widen_records(const size_t slots) {
+    const size_t old_stride = this->record_stride();
+    const size_t new_stride = 1 + 2 * slots;
+    std::vector<Degree> widened(this->node_ids.size() * new_stride, 0);
+    for (Dense_NodeID id = 0; id < this->node_ids.size(); ++id) {
+        std::copy_n(this->node_records.begin() + id * old_stride, old_stride, widened.begin() + id * new_stride);
+    }
+    this->node_records.swap(widened);
+    this->record_slots = slots;
+}
 
-    // Increase In/Out Degree of the node
-    ++this->out_degrees[edge_type][start];
-    ++this->in_degrees[edge_type][end];
+void GenericGraphReader::resize_sbm_matrices(const size_t dimension) {
+    for (auto& matrix: this->sbm_matrices) {
+        std::vector<Amount> resized(dimension * dimension, 0);
+        for (size_t x = 0; x < this->sbm_dimension; ++x) {
+            for (size_t y = 0; y < this->sbm_dimension; ++y) {
+                resized[x * dimension + y] = matrix[x * this->sbm_dimension + y];
+            }
+        }
+        matrix.swap(resized);
+    }
+    this->sbm_dimension = dimension;
+}
 
-    // Add the Color to the set of Edge-Colors
-    this->edge_colors.insert(edge_type);
+GenericGraphReader::Degree_Slots GenericGraphReader::degree_slots(const Type_ID edge_type) {
+    if (edge_type < this->record_slots) {
+        Degree* out = this->node_records.data() + 1 + 2 * edge_type;
+        return {out, out + 1, this->record_stride()};
+    }
+    auto& [out, in] = this->overflow_degrees[edge_type - this->record_slots];
+    return {out.data(), in.data(), 1};
 }
 
-m1_data GenericGraphReader::process(std::map<std::string, std::string> meta_data, std::mt19937_64::result_type seed) {
-    std::mt19937 random_source(seed);
+GenericGraphReader::Degree_Slots GenericGraphReader::shared_degree_slots(const Type_ID edge_type) {
+    Degree_Slots& cached = this->shared_degree_cache[edge_type];
+    if (cached.out != nullptr) {return cached;}
+
+    // The records of the node_source are not moved while partial readers exist, as it does not widen them. Only the
+    //  pointers to the data of its degree-arrays are cached, which stay valid when it adds further edge-types.
+    GenericGraphReader& source = *this->node_source;
+    std::lock_guard<std::mutex> guard(source.shared_degree_lock);
+    const Type_ID source_type = source.edge_types.intern(this->edge_types.name(edge_type));
+    if (source_type >= source.edge_type_counts.size()) {source.add_edge_types(false);}
+    cached = source.degree_slots(source_type);
+    return cached;
+}
 
-    std::cout << "\tCreating model...";
+Read_Result GenericGraphReader::readNode(const std::string_view node, const Type_ID node_type) {
+    // Remember this node for future lookups. Later definitions of a node overwrite earlier ones.
+    const auto [id, inserted] = this->node_ids.intern(node);
+    if (id == Node_Name_Table::NOT_FOUND) {return Read_Invalid_ID;}
+    if (inserted) {
+        this->node_records.resize(this->node_records.size() + this->record_stride(), 0);
+        for (auto& [out, in]: this->overflow_degrees) {
+            out.push_back(0);
+            in.push_back(0);
+        }
+    }
+    this->node_records[id * this->record_stride()] = node_type;
 
-    // Setup all Node/Edge-Containers
-    std::unordered_map<Node_Type, Node_Type_Container> nt_containers;
-    for (auto [n_type, cnt]: this->node_types) {
-        Node_Type_Container container = {};
-        container.node_type = n_type;
-        container.node_count = cnt;
+    ++this->node_count;
 
-        for (auto e_type: this->edge_colors) {
-            container.edge_data[e_type] = Edge_Type_Container();
-        }
-        nt_containers[n_type] = container;
+    // Increase the count of the node-color
+    ++this->node_type_counts[node_type];
+    return Read_OK;
+}
+
+
+void GenericGraphReader::finishNodes() {
+    this->node_ids.optimize_lookups();
+    if (this->node_ids.is_numeric()) {
+        std::cout << "\tNode-IDs are read as numbers" << (this->node_ids.has_direct_lookups() ? " from a dense range." : ".") << std::endl;
     }
+}
 
-    // Construct the degree-distribution for every edge-type and node-type
-    std::unordered_map<Node_Type, std::unordered_map<Edge_Type, std::unordered_map<Degree, Amount>>> in_distribution;
-    std::unordered_map<Node_Type, std::unordered_map<Edge_Type, std::unordered_map<Degree, Amount>>> out_distribution;
-    for (const auto &[e_type, nodes]: this->in_degrees) {
-        for (const auto &[node, deg]: nodes) {
-            in_distribution[this->nodes_to_types[node]][e_type][deg]++;
+
+Read_Result GenericGraphReader::readEdge(const std::string_view start, const std::string_view end, const Type_ID edge_type) {
+    // Partial readers look up the nodes in the node_source. Every node is resolved to its record exactly once.
+    GenericGraphReader& nodes = this->node_source != nullptr ? *this->node_source : *this;
+    const Dense_NodeID id_start = nodes.node_ids.find(start);
+    const Dense_NodeID id_end = nodes.node_ids.find(end);
+    if (id_start == Node_Name_Table::NOT_FOUND || id_end == Node_Name_Table::NOT_FOUND) {
+        if (!nodes.node_ids.accepts(start) || !nodes.node_ids.accepts(end)) {return Read_Invalid_ID;}
+        return Read_Unknown_Node;
+    }
+
+    ++this->edge_type_counts[edge_type];
+
+    // Increase the entry in the SBM-Matrix
+    ++this->sbm_matrices[edge_type][nodes.type_of(id_start) * this->sbm_dimension + nodes.type_of(id_end)];
+
+    // Increase In/Out Degree of the node. Partial readers update the degrees of the node_source concurrently.
+    if (this->aggregation == Degree_Aggregation::Sort) {
+        this->start_keys.push_back(endpoint_key(edge_type, id_start));
+        this->end_keys.push_back(endpoint_key(edge_type, id_end));
+    } else if (this->node_source != nullptr) {
+        const Degree_Slots slots = this->shared_degree_slots(edge_type);
+        std::atomic_ref<Degree>(slots.out[id_start * slots.stride]).fetch_add(1, std::memory_order_relaxed);
+        std::atomic_ref<Degree>(slots.in[id_end * slots.stride]).fetch_add(1, std::memory_order_relaxed);
+    } else {
+        const Degree_Slots slots = this->degree_slots(edge_type);
+        ++slots.out[id_start * slots.stride];
+        ++slots.in[id_end * slots.stride];
+    }
+    return Read_OK;
+}
+
+void GenericGraphReader::merge(GenericGraphReader& partial) {
+    this->node_count += partial.node_count;
+
+    // Partial node-readers only hold nodes, which overwrite earlier definitions. Partial edge-readers already counted
+    //  the degrees in this reader and hold only their edge-counts and SBM-Matrices.
+    const bool defines_nodes = partial.node_source == nullptr;
+    if (defines_nodes && this->node_ids.size() == 0 && this->node_types.size() == 0 && this->edge_types.size() == 0) {
+        std::swap(this->node_ids, partial.node_ids);
+        std::swap(this->node_records, partial.node_records);
+        std::swap(this->record_slots, partial.record_slots);
+        std::swap(this->node_types, partial.node_types);
+        std::swap(this->node_type_counts, partial.node_type_counts);
+        this->resize_sbm_matrices(this->node_types.size());
+        return;
+    }
+
+    std::vector<Type_ID> node_type_mapping;
+    for (Type_ID local_type = 0; local_type < partial.node_types.size(); ++local_type) {
+        const Type_ID type = this->node_types.intern(partial.node_types.name(local_type));
+        if (type >= this->node_type_counts.size()) {
+            this->node_type_counts.resize(type + 1, 0);
+            this->resize_sbm_matrices(this->node_types.size());
         }
+        this->node_type_counts[type] += partial.node_type_counts[local_type];
+        node_type_mapping.push_back(type);
     }
-    for (const auto &[e_type, nodes]: this->out_degrees) {
-        for (const auto &[node, deg]: nodes) {
-            out_distribution[this->nodes_to_types[node]][e_type][deg]++;
+
+    for (Dense_NodeID local_id = 0; local_id < partial.node_ids.size(); ++local_id) {
+        const auto [id, inserted] = this->node_ids.intern_from(partial.node_ids, local_id);
+        if (inserted) {
+            this->node_records.resize(this->node_records.size() + this->record_stride(), 0);
+            for (auto& [out, in]: this->overflow_degrees) {
+                out.push_back(0);
+                in.push_back(0);
+            }
         }
+        this->node_records[id * this->record_stride()] = node_type_mapping[partial.type_of(local_id)];
     }
 
-    // Read the degree-distributions into the proper container.
-    for (const auto &[n_type, e_cont]: in_distribution) {
-        for (const auto &[e_type, nodes]: e_cont) {
-            for (const auto &[deg, amount]: nodes) {
-                nt_containers[n_type].edge_data[e_type].in_degrees.emplace_back(std::make_pair(deg, amount));
-                nt_containers[n_type].edge_data[e_type].number_of_nodes_with_in_degree += amount;
-                nt_containers[n_type].edge_data[e_type].sum_of_in_degrees += deg*amount;
+    // The SBM-Matrices of partial edge-readers already use the node-types of this reader.
+    std::vector<Type_ID> edge_type_mapping;
+    for (Type_ID local_type = 0; local_type < partial.edge_types.size(); ++local_type) {
+        const Type_ID e_type = this->edge_types.intern(partial.edge_types.name(local_type));
+        edge_type_mapping.push_back(e_type);
+        if (e_type >= this->edge_type_counts.size()) {this->add_edge_types(true);}
+        this->edge_type_counts[e_type] += partial.edge_type_counts[local_type];
+
+        auto& matrix = this->sbm_matrices[e_type];
+        const auto& local_matrix = partial.sbm_matrices[local_type];
+        for (size_t x = 0; x < partial.sbm_dimension; ++x) {
+            for (size_t y = 0; y < partial.sbm_dimension; ++y) {
+                const Amount cnt = local_matrix[x * partial.sbm_dimension + y];
+                if (cnt == 0) {continue;}
+                const size_t type_x = defines_nodes ? node_type_mapping[x] : x;
+                const size_t type_y = defines_nodes ? node_type_mapping[y] : y;
+                matrix[type_x * this->sbm_dimension + type_y] += cnt;
             }
         }
     }
-    for (const auto &[n_type, e_cont]: out_distribution) {
-        for (const auto &[e_type, nodes]: e_cont) {
-            for (const auto &[deg, amount]: nodes) {
-                nt_containers[n_type].edge_data[e_type].out_degrees.emplace_back(std::make_pair(deg, amount));
-                nt_containers[n_type].edge_data[e_type].number_of_nodes_with_out_degree += amount;
-                nt_containers[n_type].edge_data[e_type].sum_of_out_degrees += deg*amount;
+
+    // Collected endpoints of partial edge-readers already use the dense node-IDs of this reader.
+    for (auto [keys, local_keys]: {std::pair(&this->start_keys, &partial.start_keys), std::pair(&this->end_keys, &partial.end_keys)}) {
+        keys->reserve(keys->size() + local_keys->size());
+        for (const std::uint64_t key: *local_keys) {
+            keys->push_back(endpoint_key(edge_type_mapping[key >> 32], static_cast<Dense_NodeID>(key)));
+        }
+        std::vector<std::uint64_t>().swap(*local_keys);
+    }
+}
+
+// Fisher-Yates shuffle. The algorithm of std::shuffle is left to the standard library, this one only depends on the
+//  output of the random generator, which is fully specified. Draws are made unbiased by rejecting the remainder of
+//  the range of the generator.
+template <typename T>
+void deterministic_shuffle(std::vector<T>& values, std::mt19937& random_source) {
+    for (size_t i = values.size(); i > 1; --i) {
+        const auto bound = static_cast<std::uint32_t>(i);
+        const std::uint32_t rejected = (0U - bound) % bound;    // = 2^32 mod bound
+        std::uint32_t draw;
+        do {
+            draw = static_cast<std::uint32_t>(random_source());
+        } while (draw < rejected);
+        std::swap(values[i - 1], values[draw % bound]);
+    }
+}
+
+// Deviation of the expected degrees of all nodes from their degrees in the input, summed over all distributions.
+struct Degree_Class_Deviation {
+    Amount distinct_degrees = 0;
+    Amount degree_classes = 0;
+    long double sum_of_degrees = 0;
+    long double sum_of_deviations = 0;
+};
+
+// Groups the (non-zero) degrees of a distribution into classes. Every class is represented by the rounded mean degree
+//  of its nodes. The number of edges is kept, as the probabilities of the blocks are normalized by the sum of the
+//  represented degrees. The expected degree of a node is thus its representative, scaled by the ratio of both sums.
+void bin_degrees(std::vector<std::pair<Degree, Amount> >& degrees, const Degree_Classes& classes, Degree_Class_Deviation& deviation) {
+    deviation.distinct_degrees += degrees.size();
+    if (classes.binning == Degree_Binning::None || degrees.size() <= 1) {
+        deviation.degree_classes += degrees.size();
+        return;
+    }
+
+    // Logarithmic classes relative to the lowest degree, [lowest * ratio^k, lowest * ratio^(k+1)).
+    Degree lowest = std::numeric_limits<Degree>::max();
+    Degree highest = 0;
+    for (const auto &[deg, amount]: degrees) {
+        lowest = std::min(lowest, deg);
+        highest = std::max(highest, deg);
+    }
+    long double log_ratio = std::log(classes.ratio);
+    size_t max_class = std::numeric_limits<size_t>::max();
+    if (classes.binning == Degree_Binning::Count) {
+        if (degrees.size() <= classes.count || highest == lowest) {
+            deviation.degree_classes += degrees.size();
+            return;
+        }
+        log_ratio = std::log(static_cast<long double>(highest) / lowest) / classes.count;
+        max_class = classes.count - 1;
+    }
+    auto class_of = [&](const Degree deg) {
+        const auto k = static_cast<size_t>(std::floor(std::log(static_cast<long double>(deg) / lowest) / log_ratio));
+        return std::min(k, max_class);
+    };
+
+    std::map<size_t, std::pair<long double, Amount> > class_sums;
+    long double sum_of_degrees = 0;
+    for (const auto &[deg, amount]: degrees) {
+        auto& [class_degrees, class_amount] = class_sums[class_of(deg)];
+        class_degrees += static_cast<long double>(deg) * amount;
+        class_amount += amount;
+        sum_of_degrees += static_cast<long double>(deg) * amount;
+    }
+    std::map<size_t, Degree> representatives;
+    std::map<Degree, Amount> binned;
+    long double sum_of_representatives = 0;
+    for (const auto &[k, sums]: class_sums) {
+        const auto representative = std::max<Degree>(1, std::llround(sums.first / sums.second));
+        representatives[k] = representative;
+        binned[representative] += sums.second;
+        sum_of_representatives += static_cast<long double>(representative) * sums.second;
+    }
+
+    const long double scale = sum_of_degrees / sum_of_representatives;
+    for (const auto &[deg, amount]: degrees) {
+        const long double expected = representatives[class_of(deg)] * scale;
+        deviation.sum_of_deviations += std::abs(expected - deg) * amount;
+    }
+    deviation.sum_of_degrees += sum_of_degrees;
+    deviation.degree_classes += binned.size();
+    degrees.assign(binned.begin(), binned.end());
+}
+
+m1_data build_model(const Graph_Statistics& statistics, std::map<std::string, std::string> meta_data,
+    std::mt19937_64::result_type seed, const Degree_Classes& degree_classes) {
+    std::mt19937 random_source(seed);
+
+    std::cout << "\tCreating model...";
+    Degree_Class_Deviation deviation = {};
+
+    // Setup all Node/Edge-Containers. The containers are ordered by the names of the types, which determines the
+    //  ranges of the node-IDs and the order in which the random_source is used. The model thus only depends on the
+    //  read graph and the seed, but neither on the order of the input nor on the number of threads.
+    std::map<Node_Type, Node_Type_Container> nt_containers;
+    for (size_t n_type = 0; n_type < statistics.node_types.size(); ++n_type) {
+        // Types of skipped lines are interned, but never counted.
+        if (statistics.node_type_counts[n_type] == 0) {continue;}
+        Node_Type_Container container = {};
+        container.node_type = statistics.node_types[n_type];
+        container.type_index = n_type;
+        container.node_count = statistics.node_type_counts[n_type];
+
+        for (size_t e_type = 0; e_type < statistics.edge_types.size(); ++e_type) {
+            if (statistics.edge_type_counts[e_type] == 0) {continue;}
+            auto& e_container = container.edge_data[statistics.edge_types[e_type]];
+
+            // Read the degree-distributions into the proper container, grouped into degree-classes if requested.
+            e_container.in_degrees.assign(statistics.in_degrees[n_type][e_type].begin(), statistics.in_degrees[n_type][e_type].end());
+            e_container.out_degrees.assign(statistics.out_degrees[n_type][e_type].begin(), statistics.out_degrees[n_type][e_type].end());
+            bin_degrees(e_container.in_degrees, degree_classes, deviation);
+            bin_degrees(e_container.out_degrees, degree_classes, deviation);
+            for (const auto &[deg, amount]: e_container.in_degrees) {
+                e_container.number_of_nodes_with_in_degree += amount;
+                e_container.sum_of_in_degrees += deg*amount;
+            }
+            for (const auto &[deg, amount]: e_container.out_degrees) {
+                e_container.number_of_nodes_with_out_degree += amount;
+                e_container.sum_of_out_degrees += deg*amount;
             }
         }
+        nt_containers[container.node_type] = container;
     }
 
     // Pad with 0-degree nodes where necessary.
@@ -148,9 +524,9 @@ m1_data GenericGraphReader::process(std::map<std::string, std::string> meta_data
             //      between degrees of nodes, as we cannot shuffle the degree-assignment fully, without breaking up
             //      the continuous blocks of probabilities.
             std::sort(e_container.in_degrees.begin(), e_container.in_degrees.end());
-            std::shuffle(e_container.in_degrees.begin(), e_container.in_degrees.end(), random_source);
+            deterministic_shuffle(e_container.in_degrees, random_source);
             std::sort(e_container.out_degrees.begin(), e_container.out_degrees.end());
-            std::shuffle(e_container.out_degrees.begin(), e_container.out_degrees.end(), random_source);
+            deterministic_shuffle(e_container.out_degrees, random_source);
         }
     }
 
@@ -178,81 +554,205 @@ m1_data GenericGraphReader::process(std::map<std::string, std::string> meta_data
         current_id += container.node_count;
     }
 
-    // Parse Edge-Blocks for every Edge-Type
-    Amount failed_ddcsbm_probabilities = 0;
-    Amount total_blocks = 0;
-    for (const auto &e_type: this->edge_colors) {
+    // Parse Edge-Blocks for every Edge-Type. Every pair of node-types forms an independent task, which reads the
+    //  containers without copying them. The tasks run in parallel.
+    struct Block_Task {
+        size_t record;
+        size_t x;
+        size_t y;
+        std::vector<Edge_Block> blocks;
+        Amount failed_ddcsbm_probabilities = 0;
+    };
+    std::vector<Amount> offsets;
+    Amount next_offset = 0;
+    for (const auto &container: work_container) {
+        offsets.push_back(next_offset);
+        next_offset += container.node_count;
+    }
+
+    // Data of every edge-type per node-type. Null if the node-type has no nodes with edges of the edge-type.
+    std::vector<std::vector<const Edge_Type_Container*> > out_data;
+    std::vector<std::vector<const Edge_Type_Container*> > in_data;
+    std::vector<const std::vector<Amount>*> sbm_matrices;
+    std::vector<Block_Task> tasks;
+    for (size_t e_type_id = 0; e_type_id < statistics.edge_types.size(); ++e_type_id) {
+        // Types of skipped lines are interned, but never counted.
+        if (statistics.edge_type_counts[e_type_id] == 0) {continue;}
+        const Edge_Type& e_type = statistics.edge_types[e_type_id];
         Edge_Record record = {};
         record.edge_type = e_type;
+        result_data.edges.emplace_back(record);
+        sbm_matrices.push_back(&statistics.sbm_matrices[e_type_id]);
+
+        // If the block does not have any nodes with edges with this edge type, skip. (=> Expression probability would be 0 anyway)
+        out_data.emplace_back();
+        in_data.emplace_back();
+        for (const auto &container: work_container) {
+            const Edge_Type_Container* data = container.has_edge_type(e_type) ? &container.edge_data.at(e_type) : nullptr;
+            out_data.back().push_back(data != nullptr && data->number_of_nodes_with_out_degree > 0 ? data : nullptr);
+            in_data.back().push_back(data != nullptr && data->number_of_nodes_with_in_degree > 0 ? data : nullptr);
+        }
 
-        Amount outer_id_x = 0;
-
-        for (auto container_x: work_container) {
-            // If the block does not have any nodes with edges with this edge type, skip. (=> Expression probability would be 0 anyway)
-            if (!container_x.has_edge_type(e_type) || container_x.edge_data[e_type].number_of_nodes_with_out_degree == 0) {
-                outer_id_x += container_x.node_count;
-                continue;
+        for (size_t x = 0; x < work_container.size(); ++x) {
+            if (out_data.back()[x] == nullptr) {continue;}
+            for (size_t y = 0; y < work_container.size(); ++y) {
+                if (in_data.back()[y] == nullptr) {continue;}
+                tasks.push_back({result_data.edges.size() - 1, x, y, {}, 0});
             }
+        }
+    }
 
-            Amount outer_id_y = 0;
-            // If the block does not have any nodes with edges with this edge type, skip. (=> Expression probability would be 0 anyway)
-            for (auto container_y: work_container) {
+    const size_t sbm_dimension = statistics.node_types.size();
+    run_tasks_in_parallel(tasks.size(), [&](const size_t task_idx) {
+        Block_Task& task = tasks[task_idx];
+        const Edge_Type_Container& data_x = *out_data[task.record][task.x];
+        const Edge_Type_Container& data_y = *in_data[task.record][task.y];
+        const Amount edges_between_types = (*sbm_matrices[task.record])[work_container[task.x].type_index * sbm_dimension
+            + work_container[task.y].type_index];
+        const Amount sum_of_out = data_x.sum_of_out_degrees;
+        const Amount sum_of_in = data_y.sum_of_in_degrees;
+
+        Amount current_id_x = offsets[task.x];
+        for (const auto &[deg_x, amount_x]: data_x.out_degrees) {
+            Amount current_id_y = offsets[task.y];
+            for (const auto &[deg_y, amount_y]: data_y.in_degrees) {
+                Probability prob = 0.0;
+
+                // DDcSBM-Formula. Preempt potential zero-division-errors.
+                if ( sum_of_out > 0 && sum_of_in > 0) {
+                    prob = static_cast<float>(edges_between_types) * (static_cast<float>(deg_x) / sum_of_out) * (static_cast<float>(deg_y) / sum_of_in);
+                }
 
-                if (!container_y.has_edge_type(e_type) || container_y.edge_data[e_type].number_of_nodes_with_in_degree == 0) {
-                    outer_id_y += container_y.node_count;
-                    continue;
+                // Normalize to the Interval [0,1]. Failures in the model are recorded for statistics.
+                if (prob > 1) {
+                    // prob = 1;
+                    ++task.failed_ddcsbm_probabilities;
                 }
 
-                Amount edges_between_types = this->sbm_matrix[e_type][std::make_pair(container_x.node_type, container_y.node_type)];
-                Amount current_id_x = outer_id_x;
-                for (const auto &[deg_x, amount_x]: container_x.edge_data[e_type].out_degrees) {
-                    Amount current_id_y = outer_id_y;
-                    for (const auto &[deg_y, amount_y]: container_y.edge_data[e_type].in_degrees) {
-                        const Amount sum_of_out = container_x.edge_data[e_type].sum_of_out_degrees;
-                        const Amount sum_of_in = container_y.edge_data[e_type].sum_of_in_degrees;
-                        Probability prob = 0.0;
-
-                        // DDcSBM-Formula. Preempt potential zero-division-errors.
-                        if ( sum_of_out > 0 && sum_of_in > 0) {
-                            prob = static_cast<float>(edges_between_types) * (static_cast<float>(deg_x) / sum_of_out) * (static_cast<float>(deg_y) / sum_of_in);
-                        }
-
-                        // Normalize to the Interval [0,1]. Failures in the model are recorded for statistics.
-                        if (prob > 1) {
-                            // prob = 1;
-                            ++failed_ddcsbm_probabilities;
-                        }
-
-                        // Fallback for 0-Probabilities: Only add blocks if their expression-probability is positive.
-                        if (prob > 0) {
-                            record.blocks.emplace_back(Edge_Block(current_id_x, current_id_x+amount_x,
-                                current_id_y, current_id_y+amount_y, prob));
-                            ++total_blocks;
-                        }
-
-
-                        current_id_y += amount_y;
-                    }
-                    current_id_x += amount_x;
+                // Fallback for 0-Probabilities: Only add blocks if their expression-probability is positive.
+                if (prob > 0) {
+                    task.blocks.emplace_back(Edge_Block(current_id_x, current_id_x+amount_x,
+                        current_id_y, current_id_y+amount_y, prob));
                 }
-                outer_id_y += container_y.node_count;
+
+                current_id_y += amount_y;
             }
-            outer_id_x += container_x.node_count;
+            current_id_x += amount_x;
         }
-        std::sort(record.blocks.begin(), record.blocks.end());
-        result_data.edges.emplace_back(record);
+    });
+
+    // The blocks of a task are ordered by their start, as the ids increase in both loops. All tasks of an edge-type
+    //  with the same start-node-type (a row) cover the same ranges of start-nodes, the blocks of the row are thus
+    //  ordered by interleaving the blocks of its tasks range by range. Rows are ordered by their start-node-type.
+    std::vector<std::pair<size_t, size_t> > rows;
+    for (size_t begin = 0; begin < tasks.size();) {
+        size_t end = begin + 1;
+        while (end < tasks.size() && tasks[end].record == tasks[begin].record && tasks[end].x == tasks[begin].x) {++end;}
+        rows.emplace_back(begin, end);
+        begin = end;
+    }
+    std::vector<std::vector<Edge_Block> > row_blocks(rows.size());
+    run_tasks_in_parallel(rows.size(), [&](const size_t row_idx) {
+        const auto [begin, end] = rows[row_idx];
+        std::vector<size_t> positions(end - begin, 0);
+        size_t n_blocks = 0;
+        for (size_t t = begin; t < end; ++t) {n_blocks += tasks[t].blocks.size();}
+        std::vector<Edge_Block>& blocks = row_blocks[row_idx];
+        blocks.reserve(n_blocks);
+        while (blocks.size() < n_blocks) {
+            ContinuousNodeID start_x = ContinuousNodeID::max();
+            for (size_t t = begin; t < end; ++t) {
+                if (positions[t - begin] < tasks[t].blocks.size()) {
+                    start_x = std::min(start_x, tasks[t].blocks[positions[t - begin]].startX);
+                }
+            }
+            for (size_t t = begin; t < end; ++t) {
+                size_t& position = positions[t - begin];
+                while (position < tasks[t].blocks.size() && tasks[t].blocks[position].startX == start_x) {
+                    blocks.push_back(tasks[t].blocks[position++]);
+                }
+            }
+        }
+        for (size_t t = begin; t < end; ++t) {std::vector<Edge_Block>().swap(tasks[t].blocks);}
+    });
+
+    Amount failed_ddcsbm_probabilities = 0;
+    Amount total_blocks = 0;
+    for (const auto &task: tasks) {failed_ddcsbm_probabilities += task.failed_ddcsbm_probabilities;}
+    for (size_t row_idx = 0; row_idx < rows.size(); ++row_idx) {
+        auto& record_blocks = result_data.edges[tasks[rows[row_idx].first].record].blocks;
+        record_blocks.insert(record_blocks.end(), row_blocks[row_idx].begin(), row_blocks[row_idx].end());
+        total_blocks += row_blocks[row_idx].size();
+        std::vector<Edge_Block>().swap(row_blocks[row_idx]);
     }
 
-    // As we used unordered maps before, the order of the container is non-deterministic.
-    //  We sort the containers once before processing to allow for reproducible generation.
+    // Edge-Types are written in the order of their names.
     std::sort(result_data.edges.begin(), result_data.edges.end());
     std::sort(result_data.nodes.begin(), result_data.nodes.end());
 
     std::cout << " Done." << std::endl;
+    if (degree_classes.binning != Degree_Binning::None) {
+        std::cout << "\tGrouped " << deviation.distinct_degrees << " distinct degrees into " << deviation.degree_classes
+            << " degree-classes. Expected degrees deviate from the input by "
+            << (deviation.sum_of_degrees > 0 ? 100 * deviation.sum_of_deviations / deviation.sum_of_degrees : 0) << "% on average." << std::endl;
+    }
     if (failed_ddcsbm_probabilities > 0) {
         std::cout << "\tModel failure (p > 1.0) on " << failed_ddcsbm_probabilities << " out of " << total_blocks << " blocks. ("
         << failed_ddcsbm_probabilities / (total_blocks / static_cast<long double>(100)) << "%)" << std::endl;
     }
 
     return result_data;
-}
\ No newline at end of file
+}
+
+m1_data GenericGraphReader::process(std::map<std::string, std::string> meta_data, std::mt19937_64::result_type seed,
+    const Degree_Classes& degree_classes) {
+    Graph_Statistics statistics = {};
+    for (Type_ID n_type = 0; n_type < this->node_types.size(); ++n_type) {
+        statistics.node_types.push_back(this->node_types.name(n_type));
+    }
+    for (Type_ID e_type = 0; e_type < this->edge_types.size(); ++e_type) {
+        statistics.edge_types.push_back(this->edge_types.name(e_type));
+    }
+    statistics.node_type_counts = this->node_type_counts;
+    statistics.edge_type_counts = this->edge_type_counts;
+    statistics.sbm_matrices = this->sbm_matrices;
+
+    // Construct the degree-distribution for every edge-type and node-type
+    statistics.in_degrees.assign(this->node_types.size(), std::vector<std::unordered_map<Degree, Amount> >(this->edge_types.size()));
+    statistics.out_degrees.assign(this->node_types.size(), std::vector<std::unordered_map<Degree, Amount> >(this->edge_types.size()));
+    if (this->aggregation == Degree_Aggregation::Sort) {
+        this->count_sorted_degrees(statistics);
+        return build_model(statistics, std::move(meta_data), seed, degree_classes);
+    }
+    for (Type_ID e_type = 0; e_type < this->edge_types.size(); ++e_type) {
+        const Degree_Slots slots = this->degree_slots(e_type);
+        for (Dense_NodeID id = 0; id < this->node_ids.size(); ++id) {
+            const Degree in_degree = slots.in[id * slots.stride];
+            const Degree out_degree = slots.out[id * slots.stride];
+            if (in_degree > 0) {++statistics.in_degrees[this->type_of(id)][e_type][in_degree];}
+            if (out_degree > 0) {++statistics.out_degrees[this->type_of(id)][e_type][out_degree];}
+        }
+    }
+
+    return build_model(statistics, std::move(meta_data), seed, degree_classes);
+}
+
+
+void GenericGraphReader::count_sorted_degrees(Graph_Statistics& statistics) {
+    // Equal keys are adjacent once sorted. The length of every run of equal keys is the degree of its node.
+    const size_t hardware = std::max(1U, std::thread::hardware_concurrency());
+    for (auto [keys, distribution]: {std::pair(&this->start_keys, &statistics.out_degrees), std::pair(&this->end_keys, &statistics.in_degrees)}) {
+        parallel_radix_sort(*keys, hardware);
+        size_t run_start = 0;
+        while (run_start < keys->size()) {
+            const std::uint64_t key = (*keys)[run_start];
+            size_t run_end = run_start + 1;
+            while (run_end < keys->size() && (*keys)[run_end] == key) {++run_end;}
+            const auto edge_type = static_cast<Type_ID>(key >> 32);
+            const auto id = static_cast<Dense_NodeID>(key);
+            ++(*distribution)[this->type_of(id)][edge_type][run_end - run_start];
+            run_start = run_end;
+        }
+        std::vector<std::uint64_t>().swap(*keys);
+    }
+}
@@ -1,3 +1,12 @@
+#include <deque>
+#include <limits>
+#include <string_view>
+#include <thread>
+#include "../src/graphgenerator_compressed.h"
+#include "../src/graphgenerator_mmap.h"
+#include "../src/graphgenerator_simd.h"
+
+
 // Abstract Base-Class for any additional readers.
 class TSVReader {
 public:
@@ -7,10 +16,21 @@ public:
                          size_t idx_start_node_id_, size_t idx_end_node_id_, const std::vector<size_t> &idx_edge_type_);
     ~TSVReader() = default;
 
-    m1_data readTo(GenericGraphReader &model, std::map<std::string, std::string> meta_data,
-        std::mt19937_64::result_type seed, bool debug);
+    // The model is a GenericGraphReader or an ExternalGraphReader. Files are read in parallel, if the model
+    //  SUPPORTS_PARTIALS.
+    template <typename Model>
+    m1_data readTo(Model &model, std::map<std::string, std::string> meta_data,
+        std::mt19937_64::result_type seed, const Degree_Classes& degree_classes = {}, bool debug=false);
 
 protected:
+    // Parse the lines within [begin, end) of the given file. Ranges must start at the beginning of a line.
+    template <typename Model>
+    Amount read_node_range(std::string_view content, size_t begin, size_t end, Model& model, Amount& lines_skipped, bool debug) const;
+    // Edges with a start- or end-node that was never read are skipped and counted in unknown_edges.
+    template <typename Model>
+    Amount read_edge_range(std::string_view content, size_t begin, size_t end, Model& model, Amount& lines_skipped,
+        Amount& unknown_edges, bool debug) const;
+
     std::vector<std::string> nodefiles{};
     std::vector<std::string> edgefiles{};
 
@@ -40,190 +60,356 @@ TSVReader::TSVReader(const std::vector<std::string> &node_file_paths,
 
 
 
-size_t split_on_char(const std::string &s, const char delimiter, std::vector<std::string>& container) {
-    size_t count = 0;
-    container.clear();
+// Files are split into chunks of at least this size for parallel parsing.
+constexpr size_t MIN_BYTES_PER_READER_THREAD = 1 << 22;
+
 
-    std::stringstream ss(s);
-    std::string item;
-    while (std::getline(ss, item, delimiter)) {
-        container.push_back(item);
-        ++count;
+// Splits a line on tabs into at most max_columns fields, without copying. The fields point into the given line.
+//  Columns are counted like std::getline would: A trailing empty column after the final tab is not counted.
+//  Returns the number of fields found, which is at most max_columns.
+size_t split_on_tab(const std::string_view line, std::vector<std::string_view>& container, const size_t max_columns) {
+    container.clear();
+    size_t field_start = 0;
+    while (container.size() < max_columns) {
+        const size_t field_end = line.find('\t', field_start);
+        if (field_end == std::string_view::npos) {
+            if (field_start < line.size()) {container.push_back(line.substr(field_start));}
+            break;
+        }
+        container.push_back(line.substr(field_start, field_end - field_start));
+        field_start = field_end + 1;
     }
-    return count;
+    return container.size();
 }
 
 
-m1_data TSVReader::readTo(GenericGraphReader& model, std::map<std::string, std::string> meta_data,
-    std::mt19937_64::result_type seed, bool debug=false){
-    // Read all provided Node-Files
-    for (const std::string& filename : this->nodefiles) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            throw std::runtime_error("Error opening node file '" + filename + "'.");
-        }
+// Returns the next line of the buffer starting at pos and advances pos past its line break.
+//  Stray \r characters at the end of the line are removed. These may appear in files created under windows (\r\n instead of just \n)
+std::string_view next_line(const std::string_view buffer, size_t& pos) {
+    size_t line_end = buffer.find('\n', pos);
+    if (line_end == std::string_view::npos) {line_end = buffer.size();}
+    std::string_view line = buffer.substr(pos, line_end - pos);
+    pos = line_end + 1;
+    if (line.ends_with('\r')) {line.remove_suffix(1);}
+    return line;
+}
 
-        std::filesystem::path path{filename};
-        std::cout << "\tReading '" << path.string() << "' (" << std::filesystem::file_size(path) << " byte)." << std::endl;
-        long long node_count = 0;
-        long long lines_skipped = 0;
 
-        std::string line;
+// Reads the line starting at pos into at most max_columns fields and advances pos past its line break. Tabs and
+//  newlines are found in a single pass with the given scanner. Columns are counted as in split_on_tab and stray \r
+//  characters at the end of the line are removed. The whole line is returned in line, i.e. for debugging.
+//  Returns the number of fields found, which is at most max_columns.
+size_t scan_line(const std::string_view buffer, Delimiter_Scanner& scanner, size_t& pos,
+    std::vector<std::string_view>& container, const size_t max_columns, std::string_view& line) {
+    container.clear();
+    const size_t line_start = pos;
+    size_t field_start = pos;
+    size_t delimiter = scanner.next(field_start);
+    while (delimiter < buffer.size() && buffer[delimiter] == '\t') {
+        if (container.size() < max_columns) {
+            container.push_back(buffer.substr(field_start, delimiter - field_start));
+        }
+        field_start = delimiter + 1;
+        delimiter = scanner.next(field_start);
+    }
 
+    // The final field of the line is only counted if it is not empty.
+    std::string_view last_field = buffer.substr(field_start, delimiter - field_start);
+    size_t line_end = delimiter;
+    if (last_field.ends_with('\r')) {
+        last_field.remove_suffix(1);
+        --line_end;
+    }
+    if (!last_field.empty() && container.size() < max_columns) {
+        container.push_back(last_field);
+    }
+    line = buffer.substr(line_start, line_end - line_start);
+    pos = delimiter + 1;
+    return container.size();
+}
 
-        // Skip first line, this defines the structure of the file.
-        std::getline(file, line);
-        if (line.ends_with('\r')) {
-            line.erase(line.length() - 1, 1);
-        }
-        std::vector<std::string> columns;
-        size_t expected_nbr_of_columns = split_on_char(line, '\t', columns);
-
-        // Check if the provided structure is compatible with the provided indices.
-        if (this->idx_node_id >= columns.size()) {
-            throw std::runtime_error("This file does not define enough columns to read the node-id at index "
-                + std::to_string(this->idx_node_id)
-                + ". Expected at least " + std::to_string(this->idx_node_id+1) + " columns, got " + std::to_string(columns.size()) + ".");
-        }
-        const size_t highest_idx = *std::max_element(this->idx_node_type.begin(), this->idx_node_type.end());
-        if (highest_idx >= columns.size()) {
-            throw std::runtime_error("This file does not define enough columns to read part of the node-type at index "
-                + std::to_string(highest_idx)
-                + ". Expected at least " + std::to_string(highest_idx+1) + " columns, got " + std::to_string(columns.size()) + ".");
-        }
-        // We allow incomplete rows, as long as at least the number of columns we use are present.
-        expected_nbr_of_columns = std::max(highest_idx, this->idx_node_id) + 1;
-
-        // Confirm the indices to the user.
-        std::cout << "\t\tReading the unique node-id from column '" << columns[this->idx_node_id] << "'." << std::endl;
-        std::cout << "\t\tReading the node-type as a composite from columns:";
-        for (auto idx: this->idx_node_type) {
-            std::cout << " '" << columns[idx] << "'";
+
+// Splits the range [begin, end) of the buffer into n_chunks ranges of roughly equal size. All boundaries are moved
+//  forward to the start of the next line, so that no line is split between two chunks. Chunks may be empty.
+std::vector<size_t> split_into_line_chunks(const std::string_view buffer, const size_t begin, const size_t end, const size_t n_chunks) {
+    std::vector<size_t> boundaries = {begin};
+    for (size_t i = 1; i < n_chunks; ++i) {
+        size_t boundary = begin + (end - begin) * i / n_chunks;
+        boundary = std::max(boundary, boundaries.back());
+        if (boundary > begin && boundary < end && buffer[boundary - 1] != '\n') {
+            const size_t line_end = buffer.find('\n', boundary);
+            boundary = line_end == std::string_view::npos ? end : line_end + 1;
         }
-        std::cout << "." << std::endl;
+        boundaries.push_back(std::min(boundary, end));
+    }
+    boundaries.push_back(end);
+    return boundaries;
+}
 
 
+// Number of threads used to parse a file of the given size. Small files are read on a single thread.
+size_t reader_thread_count(const size_t file_size) {
+    const size_t by_size = file_size / MIN_BYTES_PER_READER_THREAD;
+    const size_t hardware = std::max(1U, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(by_size, static_cast<size_t>(hardware)));
+}
 
-        while (std::getline(file, line)) {
-            // Remove stray \r characters. These may appear in files created under windows (\r\n instead of just \n)
-            if (line.ends_with('\r')) {
-                line.erase(line.length() - 1, 1);
-            }
 
-            // Split the line on the provided delimiter.
-            size_t actual_nbr_of_columns = split_on_char(line, '\t', columns);
-            if (actual_nbr_of_columns < expected_nbr_of_columns) {
-                ++lines_skipped;
-                if (debug) {
-                    std::cout << "\t\tSkipping invalid line: '" << line << "'" << std::endl;
+
+template <typename Model>
+m1_data TSVReader::readTo(Model& model, std::map<std::string, std::string> meta_data,
+    std::mt19937_64::result_type seed, const Degree_Classes& degree_classes, bool debug){
+    // Read all provided Node-Files
+    for (const std::string& filename : this->nodefiles) {
+        if (!std::filesystem::is_regular_file(filename)) {
+            throw std::runtime_error("Error opening node file '" + filename + "'.");
+        }
+        Text_Input input(filename);
+
+        std::filesystem::path path{filename};
+        std::cout << "\tReading '" << path.string() << "' (" << std::filesystem::file_size(path) << " byte"
+            << input.description() << ")." << std::endl;
+        Amount node_count = 0;
+        Amount lines_skipped = 0;
+
+        // Compressed files are parsed block by block, while the next block is decompressed.
+        std::string_view content;
+        bool read_header = false;
+        while (input.next_block(content)) {
+            size_t pos = 0;
+            if (!read_header) {
+                // Skip first line, this defines the structure of the file.
+                std::vector<std::string_view> columns;
+                split_on_tab(next_line(content, pos), columns, std::numeric_limits<size_t>::max());
+
+                // Check if the provided structure is compatible with the provided indices.
+                if (this->idx_node_id >= columns.size()) {
+                    throw std::runtime_error("This file does not define enough columns to read the node-id at index "
+                        + std::to_string(this->idx_node_id)
+                        + ". Expected at least " + std::to_string(this->idx_node_id+1) + " columns, got " + std::to_string(columns.size()) + ".");
+                }
+                const size_t highest_idx = *std::max_element(this->idx_node_type.begin(), this->idx_node_type.end());
+                if (highest_idx >= columns.size()) {
+                    throw std::runtime_error("This file does not define enough columns to read part of the node-type at index "
+                        + std::to_string(highest_idx)
+                        + ". Expected at least " + std::to_string(highest_idx+1) + " columns, got " + std::to_string(columns.size()) + ".");
                 }
-                continue;
+                // Confirm the indices to the user.
+                std::cout << "\t\tReading the unique node-id from column '" << columns[this->idx_node_id] << "'." << std::endl;
+                std::cout << "\t\tReading the node-type as a composite from columns:";
+                for (auto idx: this->idx_node_type) {
+                    std::cout << " '" << columns[idx] << "'";
+                }
+                std::cout << "." << std::endl;
+                read_header = true;
             }
 
-            // Read the node-ID and node-type based on the configuration. The Node-Type can be a composite from multiple columns.
-            std::string node_id = columns[this->idx_node_id];
-            std::string node_type = "";
-            for (auto idx: this->idx_node_type) {
-                node_type.append(columns[idx] + "_");
+            // Every thread reads its own chunk into a partial model. The partial models are merged in the order of the chunks.
+            const size_t n_threads = Model::SUPPORTS_PARTIALS ? reader_thread_count(content.size() - pos) : 1;
+            const std::vector<size_t> chunks = split_into_line_chunks(content, pos, content.size(), n_threads);
+            const size_t n_chunks = chunks.size() - 1;
+            if (n_chunks == 1) {
+                node_count += this->read_node_range(content, chunks[0], chunks[1], model, lines_skipped, debug);
+            } else if constexpr (Model::SUPPORTS_PARTIALS) {
+                std::deque<Model> partials;
+                for (size_t i = 0; i < n_chunks; ++i) {partials.emplace_back(model.nodeIDMode(), model.degreeAggregation());}
+                std::vector<Amount> counts(n_chunks, 0);
+                std::vector<Amount> skipped(n_chunks, 0);
+                std::vector<std::thread> threads;
+                for (size_t i = 0; i < n_chunks; ++i) {
+                    threads.emplace_back([&, i]() {
+                        counts[i] = this->read_node_range(content, chunks[i], chunks[i+1], partials[i], skipped[i], debug);
+                    });
+                }
+                for (auto& thread: threads) {thread.join();}
+                for (size_t i = 0; i < n_chunks; ++i) {
+                    model.merge(partials[i]);
+                    node_count += counts[i];
+                    lines_skipped += skipped[i];
+                }
             }
-            if (node_type.size() != 0) {node_type.erase(node_type.length() - 1, 1);} // Remove the trailing underscore.
-
-            model.readNode(node_id, node_type);
-            ++node_count;
         }
-        file.close();
         std::cout << "\t\tRead: " << node_count << " Nodes. Skipped " << lines_skipped << " lines." << std::endl;
     }
 
 
+    model.finishNodes();
+
     // Read all Edge-Files
     for (const std::string& filename : this->edgefiles) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
+        if (!std::filesystem::is_regular_file(filename)) {
             throw std::runtime_error("Error opening edge file '" + filename + "'.");
         }
+        Text_Input input(filename);
 
         std::filesystem::path path{filename};
-        std::cout << "\tReading '" << path.string() << "' (" << std::filesystem::file_size(path) << " byte)." << std::endl;
-        long long edge_count = 0;
-        long long lines_skipped = 0;
-
-        std::string line;
+        std::cout << "\tReading '" << path.string() << "' (" << std::filesystem::file_size(path) << " byte"
+            << input.description() << ")." << std::endl;
+        Amount edge_count = 0;
+        Amount lines_skipped = 0;
+        Amount unknown_edges = 0;
+
+        // Compressed files are parsed block by block, while the next block is decompressed.
+        std::string_view content;
+        bool read_header = false;
+        while (input.next_block(content)) {
+            size_t pos = 0;
+            if (!read_header) {
+                // Skip first line, this defines the structure of the file.
+                std::vector<std::string_view> columns;
+                split_on_tab(next_line(content, pos), columns, std::numeric_limits<size_t>::max());
+
+                // Check if the provided structure is compatible with the provided indices.
+                if (this->idx_start_node_id >= columns.size()) {
+                    throw std::runtime_error("This file does not define enough columns to read the start-node-id at index "
+                        + std::to_string(this->idx_start_node_id)
+                        + ". Expected at least " + std::to_string(this->idx_start_node_id+1) + " columns, got " + std::to_string(columns.size()) + ".");
+                }
+                if (this->idx_end_node_id >= columns.size()) {
+                    throw std::runtime_error("This file does not define enough columns to read the end-node-id at index "
+                        + std::to_string(this->idx_end_node_id)
+                        + ". Expected at least " + std::to_string(this->idx_end_node_id+1) + " columns, got " + std::to_string(columns.size()) + ".");
+                }
+                const size_t highest_idx = *std::max_element(this->idx_edge_type.begin(), this->idx_edge_type.end());
+                if (highest_idx >= columns.size()) {
+                    throw std::runtime_error("This file does not define enough columns to read part of the edge-type at index "
+                        + std::to_string(highest_idx)
+                        + ". Expected at least " + std::to_string(highest_idx+1) + " columns, got " + std::to_string(columns.size()) + ".");
+                }
 
+                // Confirm the indices to the user.
+                std::cout << "\t\tReading the unique start-node-id from column '" << columns[this->idx_start_node_id] << "'." << std::endl;
+                std::cout << "\t\tReading the unique end-node-id from column '" << columns[this->idx_end_node_id] << "'." << std::endl;
+                std::cout << "\t\tReading the edge-type as a composite from columns:";
+                for (auto idx: this->idx_edge_type) {
+                    std::cout << " '" << columns[idx] << "'";
+                }
+                std::cout << "." << std::endl;
+                read_header = true;
+            }
 
-        // Skip first line, this defines the structure of the file.
-        std::getline(file, line);
-        if (line.ends_with('\r')) {
-            line.erase(line.length() - 1, 1);
-        }
-        std::vector<std::string> columns;
-        size_t expected_nbr_of_columns = split_on_char(line, '\t', columns);
-
-        // Check if the provided structure is compatible with the provided indices.
-        if (this->idx_start_node_id >= columns.size()) {
-            throw std::runtime_error("This file does not define enough columns to read the start-node-id at index "
-                + std::to_string(this->idx_start_node_id)
-                + ". Expected at least " + std::to_string(this->idx_start_node_id+1) + " columns, got " + std::to_string(columns.size()) + ".");
-        }
-        if (this->idx_end_node_id >= columns.size()) {
-            throw std::runtime_error("This file does not define enough columns to read the end-node-id at index "
-                + std::to_string(this->idx_end_node_id)
-                + ". Expected at least " + std::to_string(this->idx_end_node_id+1) + " columns, got " + std::to_string(columns.size()) + ".");
+            // Every thread reads its own chunk into a partial model, which looks up the nodes in the shared model.
+            //  The nodes are no longer modified at this point, so the lookups are safe without locking.
+            const size_t n_threads = Model::SUPPORTS_PARTIALS ? reader_thread_count(content.size() - pos) : 1;
+            const std::vector<size_t> chunks = split_into_line_chunks(content, pos, content.size(), n_threads);
+            const size_t n_chunks = chunks.size() - 1;
+            if (n_chunks == 1) {
+                edge_count += this->read_edge_range(content, chunks[0], chunks[1], model, lines_skipped, unknown_edges, debug);
+            } else if constexpr (Model::SUPPORTS_PARTIALS) {
+                std::deque<Model> partials;
+                for (size_t i = 0; i < n_chunks; ++i) {partials.emplace_back(&model);}
+                std::vector<Amount> counts(n_chunks, 0);
+                std::vector<Amount> skipped(n_chunks, 0);
+                std::vector<Amount> unknown(n_chunks, 0);
+                std::vector<std::thread> threads;
+                for (size_t i = 0; i < n_chunks; ++i) {
+                    threads.emplace_back([&, i]() {
+                        counts[i] = this->read_edge_range(content, chunks[i], chunks[i+1], partials[i], skipped[i], unknown[i], debug);
+                    });
+                }
+                for (auto& thread: threads) {thread.join();}
+                for (size_t i = 0; i < n_chunks; ++i) {
+                    model.merge(partials[i]);
+                    edge_count += counts[i];
+                    lines_skipped += skipped[i];
+                    unknown_edges += unknown[i];
+                }
+            }
         }
-        const size_t highest_idx = *std::max_element(this->idx_edge_type.begin(), this->idx_edge_type.end());
-        if (highest_idx >= columns.size()) {
-            throw std::runtime_error("This file does not define enough columns to read part of the edge-type at index "
-                + std::to_string(highest_idx)
-                + ". Expected at least " + std::to_string(highest_idx+1) + " columns, got " + std::to_string(columns.size()) + ".");
+        std::cout << "\t\tRead: " << edge_count << " Edges. Skipped " << lines_skipped << " lines." << std::endl;
+        if (unknown_edges > 0) {
+            std::cout << "\t\tSkipped " << unknown_edges << " edges with a start- or end-node that is not defined in the node-files." << std::endl;
         }
+    }
 
-        // We allow incomplete rows, as long as at least the number of columns we use are present.
-        expected_nbr_of_columns = std::max(this->idx_start_node_id, this->idx_end_node_id);
-        expected_nbr_of_columns = std::max(highest_idx, expected_nbr_of_columns) + 1;
+    return model.process(meta_data, seed, degree_classes);
+}
 
-        // Confirm the indices to the user.
-        std::cout << "\t\tReading the unique start-node-id from column '" << columns[this->idx_start_node_id] << "'." << std::endl;
-        std::cout << "\t\tReading the unique end-node-id from column '" << columns[this->idx_end_node_id] << "'." << std::endl;
-        std::cout << "\t\tReading the edge-type as a composite from columns:";
-        for (auto idx: this->idx_edge_type) {
-            std::cout << " '" << columns[idx] << "'";
-        }
-        std::cout << "." << std::endl;
 
+template <typename Model>
+Amount TSVReader::read_node_range(const std::string_view content, const size_t begin, const size_t end, Model& model,
+    Amount& lines_skipped, const bool debug) const {
+    // We allow incomplete rows, as long as at least the number of columns we use are present.
+    const size_t expected_nbr_of_columns = std::max(*std::max_element(this->idx_node_type.begin(), this->idx_node_type.end()), this->idx_node_id) + 1;
+    const std::string_view range = content.substr(0, end);
+    Amount node_count = 0;
+
+    // The lines are scanned in place. Node-IDs and types are interned directly from the buffer.
+    std::vector<std::string_view> columns;
+    Delimiter_Scanner scanner(range);
+    std::string_view line;
+    size_t pos = begin;
+    while (pos < end) {
+        // Split the line on the provided delimiter.
+        size_t actual_nbr_of_columns = scan_line(range, scanner, pos, columns, expected_nbr_of_columns, line);
+        if (actual_nbr_of_columns < expected_nbr_of_columns) {
+            ++lines_skipped;
+            if (debug) {
+                std::cout << "\t\tSkipping invalid line: '" << line << "'" << std::endl;
+            }
+            continue;
+        }
 
+        // Read the node-ID and node-type based on the configuration. The Node-Type can be a composite from multiple columns.
+        const Type_ID node_type = model.internNodeType(columns, this->idx_node_type);
 
-        while (std::getline(file, line)) {
-            // Remove stray \r characters. These may appear in files created under windows (\r\n instead of just \n)
-            if (line.ends_with('\r')) {
-                line.erase(line.length() - 1, 1);
+        if (model.readNode(columns[this->idx_node_id], node_type) != Read_OK) {
+            ++lines_skipped;
+            if (debug) {
+                std::cout << "\t\tSkipping line with a non-numeric node-id: '" << line << "'" << std::endl;
             }
+            continue;
+        }
+        ++node_count;
+    }
+    return node_count;
+}
 
-            // Split the line on the provided delimiter.
-            size_t actual_nbr_of_columns = split_on_char(line, '\t', columns);
-            if (actual_nbr_of_columns < expected_nbr_of_columns) {
-                ++lines_skipped;
-                if (debug) {
-                    std::cout << "\t\tSkipping invalid line: '" << line << "'" << std::endl;
-                }
-                continue;
-            }
 
-            // Read the node-IDs and edge-type based on the configuration. The edge-type can be a composite from multiple columns.
-            std::string start_node_id = columns[this->idx_start_node_id];
-            std::string end_node_id = columns[this->idx_end_node_id];
-            std::string edge_type = "";
-            for (auto idx: this->idx_edge_type) {
-                edge_type.append(columns[idx] + "_");
+template <typename Model>
+Amount TSVReader::read_edge_range(const std::string_view content, const size_t begin, const size_t end, Model& model,
+    Amount& lines_skipped, Amount& unknown_edges, const bool debug) const {
+    // We allow incomplete rows, as long as at least the number of columns we use are present.
+    size_t expected_nbr_of_columns = std::max(this->idx_start_node_id, this->idx_end_node_id);
+    expected_nbr_of_columns = std::max(*std::max_element(this->idx_edge_type.begin(), this->idx_edge_type.end()), expected_nbr_of_columns) + 1;
+    const std::string_view range = content.substr(0, end);
+    Amount edge_count = 0;
+
+    // The lines are scanned in place. Node-IDs and types are interned directly from the buffer.
+    std::vector<std::string_view> columns;
+    Delimiter_Scanner scanner(range);
+    std::string_view line;
+    size_t pos = begin;
+    while (pos < end) {
+        // Split the line on the provided delimiter.
+        size_t actual_nbr_of_columns = scan_line(range, scanner, pos, columns, expected_nbr_of_columns, line);
+        if (actual_nbr_of_columns < expected_nbr_of_columns) {
+            ++lines_skipped;
+            if (debug) {
+                std::cout << "\t\tSkipping invalid line: '" << line << "'" << std::endl;
             }
-            if (edge_type.size() != 0) {edge_type.erase(edge_type.length() - 1, 1);} // Remove the trailing underscore.
+            continue;
+        }
+
+        // Read the node-IDs and edge-type based on the configuration. The edge-type can be a composite from multiple columns.
+        const Type_ID edge_type = model.internEdgeType(columns, this->idx_edge_type);
 
-            model.readEdge(start_node_id, end_node_id, edge_type);
-            ++edge_count;
+        const Read_Result result = model.readEdge(columns[this->idx_start_node_id], columns[this->idx_end_node_id], edge_type);
+        if (result == Read_Invalid_ID) {
+            ++lines_skipped;
+            if (debug) {
+                std::cout << "\t\tSkipping line with a non-numeric node-id: '" << line << "'" << std::endl;
+            }
+            continue;
         }
-        file.close();
-        std::cout << "\t\tRead: " << edge_count << " Edges. Skipped " << lines_skipped << " lines." << std::endl;
+        if (result == Read_Unknown_Node) {
+            ++unknown_edges;
+            if (debug) {
+                std::cout << "\t\tSkipping edge with an unknown node: '" << line << "'" << std::endl;
+            }
+            continue;
+        }
+        ++edge_count;
     }
-
-    return model.process(meta_data, seed);
+    return edge_count;
 }
-
@@ -0,0 +1,611 @@
+#ifndef GRAPHGENERATOR_COMPRESSED_H
+#define GRAPHGENERATOR_COMPRESSED_H
+
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "../src/graphgenerator_mmap.h"
+
+// Support for compressed files is optional. The build defines these if the libraries are available.
+#ifdef GRAPHGENERATOR_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef GRAPHGENERATOR_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+
+enum class Compression {None, Gzip, Zstd, Zip};
+
+// Detects the compression of a file from its first bytes. Files of any other format are read as plain text.
+//  Of zip-archives, the first file is read.
+inline Compression detect_compression(const std::string& file_name) {
+    std::ifstream file(file_name, std::ios::binary);
+    unsigned char magic[4] = {};
+    file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+    if (file.gcount() >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {return Compression::Gzip;}
+    if (file.gcount() == 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) {
+        return Compression::Zstd;
+    }
+    if (file.gcount() == 4 && magic[0] == 'P' && magic[1] == 'K' && magic[2] == 0x03 && magic[3] == 0x04) {
+        return Compression::Zip;
+    }
+    return Compression::None;
+}
+
+// Compression of a file that is written, chosen by the extension of its name.
+inline Compression compression_for_extension(const std::string& file_name) {
+    const std::filesystem::path extension = std::filesystem::path(file_name).extension();
+    if (extension == ".gz") {return Compression::Gzip;}
+    if (extension == ".zst") {return Compression::Zstd;}
+    if (extension == ".zip") {
+        throw std::runtime_error("Zip-archives can only be read. Use '.gz' or '.zst' to write '" + file_name + "' compressed.");
+    }
+    return Compression::None;
+}
+
+inline std::string compression_name(const Compression compression) {
+    switch (compression) {
+        case Compression::Gzip: return "gzip";
+        case Compression::Zstd: return "zstd";
+        case Compression::Zip: return "zip";
+        default: return "plain";
+    }
+}
+
+
+// Decompresses a file on a separate thread, while the previous blocks are parsed. The decompressed data is handed out
+//  in blocks of complete lines: A line that is cut off at the end of a block is moved to the start of the next one.
+//  At most MAX_QUEUED_BLOCKS decompressed blocks are kept ahead of the parser. Plain files are read ahead the same way.
+class Decompressing_Reader {
+public:
+    // Blocks are decompressed in the given size. Smaller blocks reduce the memory held ahead of the parser.
+    Decompressing_Reader(const std::string& file_name_, const Compression compression_, const size_t block_size_ = DEFAULT_BLOCK_SIZE):
+        file_name(file_name_), compression(compression_), block_size(block_size_) {
+#ifndef GRAPHGENERATOR_WITH_ZLIB
+        if (this->compression == Compression::Gzip || this->compression == Compression::Zip) {
+            throw std::runtime_error("File '" + this->file_name + "' is " + compression_name(this->compression)
+                + "-compressed, but the generator was built without zlib.");
+        }
+#endif
+#ifndef GRAPHGENERATOR_WITH_ZSTD
+        if (this->compression == Compression::Zstd) {
+            throw std::runtime_error("File '" + this->file_name + "' is zstd-compressed, but the generator was built without zstd.");
+        }
+#endif
+        this->worker = std::thread(&Decompressing_Reader::run, this);
+    }
+
+    ~Decompressing_Reader() {
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->stopped = true;
+        }
+        this->changed.notify_all();
+        this->worker.join();
+    }
+
+    Decompressing_Reader(const Decompressing_Reader&) = delete;
+    Decompressing_Reader& operator=(const Decompressing_Reader&) = delete;
+
+    // Returns the next block of complete lines, which is valid until the next call. The final line of the file may
+    //  lack its line break. Returns at least one (possibly empty) block, false once the file is exhausted.
+    bool next_block(std::string_view& block) {
+        // Keep the line that was cut off at the end of the previous block.
+        this->current.erase(0, this->handed_out);
+        this->handed_out = 0;
+
+        while (true) {
+            std::string decompressed;
+            bool exhausted;
+            {
+                std::unique_lock<std::mutex> guard(this->lock);
+                this->changed.wait(guard, [this]() {return !this->queue.empty() || this->finished || this->error;});
+                if (this->error) {std::rethrow_exception(this->error);}
+                exhausted = this->queue.empty();
+                if (!exhausted) {
+                    decompressed = std::move(this->queue.front());
+                    this->queue.pop_front();
+                }
+            }
+            this->changed.notify_all();
+
+            if (exhausted) {
+                if (this->current.empty() && this->any_block) {return false;}
+                this->any_block = true;
+                this->handed_out = this->current.size();
+                block = this->current;
+                return true;
+            }
+
+            this->current.append(decompressed);
+            const size_t last_line_break = this->current.rfind('\n');
+            if (last_line_break != std::string::npos) {
+                this->any_block = true;
+                this->handed_out = last_line_break + 1;
+                block = std::string_view(this->current).substr(0, this->handed_out);
+                return true;
+            }
+        }
+    }
+
+private:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 1 << 24;
+    static constexpr size_t INPUT_BUFFER_SIZE = 1 << 20;
+    static constexpr size_t MAX_QUEUED_BLOCKS = 2;
+
+    // Runs on the worker-thread. Any error is handed to the parser.
+    void run() {
+        try {
+            std::ifstream file(this->file_name, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Could not open file '" + this->file_name + "' for reading.");
+            }
+            if (this->compression == Compression::Gzip) {
+                this->inflate_gzip(file);
+            } else if (this->compression == Compression::Zstd) {
+                this->decompress_zstd(file);
+            } else if (this->compression == Compression::Zip) {
+                this->inflate_zip(file);
+            } else {
+                this->read_plain(file);
+            }
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->finished = true;
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->error = std::current_exception();
+        }
+        this->changed.notify_all();
+    }
+
+    // Hands a decompressed block to the parser. Waits while the parser is behind. Returns false if the reader stopped.
+    bool push_block(std::string& block) {
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->changed.wait(guard, [this]() {return this->queue.size() < MAX_QUEUED_BLOCKS || this->stopped;});
+        if (this->stopped) {return false;}
+        this->queue.push_back(std::move(block));
+        guard.unlock();
+        this->changed.notify_all();
+        block.clear();
+        return true;
+    }
+
+    size_t read_input(std::ifstream& file, std::vector<char>& input) {
+        file.read(input.data(), static_cast<std::streamsize>(input.size()));
+        if (file.bad()) {throw std::runtime_error("Could not read file '" + this->file_name + "'.");}
+        return static_cast<size_t>(file.gcount());
+    }
+
+    void read_plain(std::ifstream& file) {
+        std::string output(this->block_size, '\0');
+        while (true) {
+            file.read(output.data(), static_cast<std::streamsize>(this->block_size));
+            if (file.bad()) {throw std::runtime_error("Could not read file '" + this->file_name + "'.");}
+            output.resize(static_cast<size_t>(file.gcount()));
+            if (output.empty() || !this->push_block(output)) {return;}
+            output.resize(this->block_size);
+        }
+    }
+
+    // The decompressors read the next input only once the previous output did not fill a whole block, as the
+    //  decompressor may hold back further output otherwise.
+    void inflate_gzip(std::ifstream& file) {
+#ifdef GRAPHGENERATOR_WITH_ZLIB
+        std::vector<char> input(INPUT_BUFFER_SIZE);
+        std::string output;
+        z_stream stream = {};
+        // 15 + 32: Maximum window size, detect gzip- and zlib-headers automatically.
+        if (inflateInit2(&stream, 15 + 32) != Z_OK) {throw std::runtime_error("Could not initialize zlib.");}
+        try {
+            bool end_of_stream = false;
+            bool output_full = false;
+            while (true) {
+                if (stream.avail_in == 0 && !output_full) {
+                    stream.avail_in = static_cast<uInt>(this->read_input(file, input));
+                    stream.next_in = reinterpret_cast<Bytef*>(input.data());
+                    if (stream.avail_in == 0) {break;}
+                }
+                // Files may consist of several concatenated gzip-members.
+                if (end_of_stream && stream.avail_in > 0) {
+                    inflateReset(&stream);
+                    end_of_stream = false;
+                }
+                const size_t written = output.size();
+                output.resize(this->block_size);
+                stream.next_out = reinterpret_cast<Bytef*>(output.data() + written);
+                stream.avail_out = static_cast<uInt>(this->block_size - written);
+                const int result = inflate(&stream, Z_NO_FLUSH);
+                output.resize(this->block_size - stream.avail_out);
+                if (result == Z_STREAM_END) {
+                    end_of_stream = true;
+                } else if (result != Z_OK && result != Z_BUF_ERROR) {
+                    throw std::runtime_error("File '" + this->file_name + "' is not a valid gzip-file.");
+                }
+                output_full = output.size() == this->block_size;
+                if (output_full && !this->push_block(output)) {
+                    inflateEnd(&stream);
+                    return;
+                }
+            }
+            if (!end_of_stream) {
+                throw std::runtime_error("File '" + this->file_name + "' ends within the compressed data.");
+            }
+            if (!output.empty()) {this->push_block(output);}
+        } catch (...) {
+            inflateEnd(&stream);
+            throw;
+        }
+        inflateEnd(&stream);
+#else
+        (void) file;
+#endif
+    }
+
+    // Reads the first file of a zip-archive. Its position, size and checksum are taken from the central directory at
+    //  the end of the archive, as the local header may leave them out. Zip64-archives are supported.
+    void inflate_zip(std::ifstream& file) {
+#ifdef GRAPHGENERATOR_WITH_ZLIB
+        const auto invalid = [this]() {return std::runtime_error("File '" + this->file_name + "' is not a valid zip-archive.");};
+        auto read_at = [&](const std::uint64_t position, void* target, const size_t n) {
+            file.clear();
+            file.seekg(static_cast<std::streamoff>(position));
+            file.read(static_cast<char*>(target), static_cast<std::streamsize>(n));
+            if (static_cast<size_t>(file.gcount()) != n) {throw invalid();}
+        };
+        auto u16 = [](const unsigned char* p) {return static_cast<std::uint16_t>(p[0] | p[1] << 8);};
+        auto u32 = [](const unsigned char* p) {return static_cast<std::uint32_t>(p[0] | p[1] << 8 | p[2] << 16 | static_cast<std::uint32_t>(p[3]) << 24);};
+        auto u64 = [&](const unsigned char* p) {return u32(p) | static_cast<std::uint64_t>(u32(p + 4)) << 32;};
+
+        // The end of central directory record is within the last 64 kB (its comment) + 22 bytes.
+        file.seekg(0, std::ios::end);
+        const auto file_size = static_cast<std::uint64_t>(file.tellg());
+        const std::uint64_t tail_size = std::min<std::uint64_t>(file_size, (1 << 16) + 22);
+        std::vector<unsigned char> tail(tail_size);
+        read_at(file_size - tail_size, tail.data(), tail.size());
+        size_t end_record = tail_size < 22 ? std::string::npos : tail_size - 22;
+        while (end_record != std::string::npos && u32(&tail[end_record]) != 0x06054B50) {
+            end_record = end_record == 0 ? std::string::npos : end_record - 1;
+        }
+        if (end_record == std::string::npos) {throw invalid();}
+        std::uint64_t directory = u32(&tail[end_record + 16]);
+        if (directory == 0xFFFFFFFF) {
+            // The zip64 end of central directory locator precedes the record.
+            unsigned char locator[20];
+            read_at(file_size - tail_size + end_record - 20, locator, sizeof(locator));
+            if (u32(locator) != 0x07064B50) {throw invalid();}
+            unsigned char record[56];
+            read_at(u64(locator + 8), record, sizeof(record));
+            if (u32(record) != 0x06064B50) {throw invalid();}
+            directory = u64(record + 48);
+        }
+
+        // Find the first entry that is not a directory.
+        std::uint16_t method = 0;
+        std::uint32_t checksum = 0;
+        std::uint64_t compressed_size = 0, local_header = 0;
+        while (true) {
+            unsigned char entry[46];
+            read_at(directory, entry, sizeof(entry));
+            if (u32(entry) != 0x02014B50) {throw std::runtime_error("Zip-archive '" + this->file_name + "' contains no file.");}
+            const std::uint16_t name_length = u16(entry + 28), extra_length = u16(entry + 30), comment_length = u16(entry + 32);
+            std::vector<unsigned char> variable(name_length + extra_length);
+            read_at(directory + sizeof(entry), variable.data(), variable.size());
+            directory += sizeof(entry) + name_length + extra_length + comment_length;
+            if (name_length > 0 && variable[name_length - 1] == '/') {continue;}
+
+            method = u16(entry + 10);
+            checksum = u32(entry + 16);
+            compressed_size = u32(entry + 20);
+            std::uint64_t uncompressed_size = u32(entry + 24);
+            local_header = u32(entry + 42);
+            // Sizes and offsets that do not fit into 32 bits are given in the zip64 extra field, in this order.
+            for (size_t pos = name_length; pos + 4 <= variable.size();) {
+                const std::uint16_t id = u16(&variable[pos]), length = u16(&variable[pos + 2]);
+                if (id == 0x0001) {
+                    size_t field = pos + 4;
+                    for (std::uint64_t* value: {&uncompressed_size, &compressed_size, &local_header}) {
+                        if (*value == 0xFFFFFFFF && field + 8 <= pos + 4 + length) {
+                            *value = u64(&variable[field]);
+                            field += 8;
+                        }
+                    }
+                }
+                pos += 4 + length;
+            }
+            break;
+        }
+        if (method != 0 && method != 8) {
+            throw std::runtime_error("Zip-archive '" + this->file_name + "' uses an unsupported compression method ("
+                + std::to_string(method) + "). Only stored and deflated files can be read.");
+        }
+
+        unsigned char header[30];
+        read_at(local_header, header, sizeof(header));
+        if (u32(header) != 0x04034B50) {throw invalid();}
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(local_header + sizeof(header) + u16(header + 26) + u16(header + 28)));
+
+        // Stored files are copied, deflated files are inflated without a header (-15).
+        std::vector<char> input(INPUT_BUFFER_SIZE);
+        std::string output;
+        uLong crc = crc32(0L, Z_NULL, 0);
+        z_stream stream = {};
+        if (method == 8 && inflateInit2(&stream, -15) != Z_OK) {throw std::runtime_error("Could not initialize zlib.");}
+        try {
+            std::uint64_t remaining = compressed_size;
+            bool end_of_stream = method == 0 && remaining == 0;
+            bool output_full = false;
+            while (!end_of_stream) {
+                if (stream.avail_in == 0 && !output_full) {
+                    file.read(input.data(), static_cast<std::streamsize>(std::min<std::uint64_t>(input.size(), remaining)));
+                    stream.avail_in = static_cast<uInt>(file.gcount());
+                    stream.next_in = reinterpret_cast<Bytef*>(input.data());
+                    remaining -= stream.avail_in;
+                    if (stream.avail_in == 0) {break;}
+                }
+                const size_t written = output.size();
+                output.resize(this->block_size);
+                if (method == 0) {
+                    const size_t n = std::min<size_t>(stream.avail_in, this->block_size - written);
+                    std::memcpy(output.data() + written, stream.next_in, n);
+                    stream.next_in += n;
+                    stream.avail_in -= static_cast<uInt>(n);
+                    output.resize(written + n);
+                    end_of_stream = remaining == 0 && stream.avail_in == 0;
+                } else {
+                    stream.next_out = reinterpret_cast<Bytef*>(output.data() + written);
+                    stream.avail_out = static_cast<uInt>(this->block_size - written);
+                    const int result = inflate(&stream, Z_NO_FLUSH);
+                    output.resize(this->block_size - stream.avail_out);
+                    if (result == Z_STREAM_END) {
+                        end_of_stream = true;
+                    } else if (result != Z_OK && result != Z_BUF_ERROR) {
+                        throw invalid();
+                    }
+                }
+                crc = crc32(crc, reinterpret_cast<const Bytef*>(output.data() + written), static_cast<uInt>(output.size() - written));
+                output_full = output.size() == this->block_size;
+                if (output_full && !this->push_block(output)) {
+                    if (method == 8) {inflateEnd(&stream);}
+                    return;
+                }
+            }
+            if (!end_of_stream) {
+                throw std::runtime_error("File '" + this->file_name + "' ends within the compressed data.");
+            }
+            if (crc != checksum) {
+                throw std::runtime_error("The checksum of zip-archive '" + this->file_name + "' does not match its content.");
+            }
+            if (!output.empty()) {this->push_block(output);}
+        } catch (...) {
+            if (method == 8) {inflateEnd(&stream);}
+            throw;
+        }
+        if (method == 8) {inflateEnd(&stream);}
+#else
+        (void) file;
+#endif
+    }
+
+    void decompress_zstd(std::ifstream& file) {
+#ifdef GRAPHGENERATOR_WITH_ZSTD
+        std::vector<char> input(INPUT_BUFFER_SIZE);
+        std::string output;
+        ZSTD_DStream* stream = ZSTD_createDStream();
+        if (stream == nullptr) {throw std::runtime_error("Could not initialize zstd.");}
+        try {
+            ZSTD_initDStream(stream);
+            ZSTD_inBuffer in_buffer = {input.data(), 0, 0};
+            size_t remaining_in_frame = 0;
+            bool output_full = false;
+            while (true) {
+                if (in_buffer.pos == in_buffer.size && !output_full) {
+                    in_buffer.size = this->read_input(file, input);
+                    in_buffer.pos = 0;
+                    if (in_buffer.size == 0) {break;}
+                }
+                const size_t written = output.size();
+                output.resize(this->block_size);
+                ZSTD_outBuffer out_buffer = {output.data(), this->block_size, written};
+                remaining_in_frame = ZSTD_decompressStream(stream, &out_buffer, &in_buffer);
+                if (ZSTD_isError(remaining_in_frame)) {
+                    throw std::runtime_error("File '" + this->file_name + "' is not a valid zstd-file: "
+                        + ZSTD_getErrorName(remaining_in_frame));
+                }
+                output.resize(out_buffer.pos);
+                output_full = output.size() == this->block_size;
+                if (output_full && !this->push_block(output)) {
+                    ZSTD_freeDStream(stream);
+                    return;
+                }
+            }
+            if (remaining_in_frame != 0) {
+                throw std::runtime_error("File '" + this->file_name + "' ends within the compressed data.");
+            }
+            if (!output.empty()) {this->push_block(output);}
+        } catch (...) {
+            ZSTD_freeDStream(stream);
+            throw;
+        }
+        ZSTD_freeDStream(stream);
+#else
+        (void) file;
+#endif
+    }
+
+    std::string file_name;
+    Compression compression;
+    size_t block_size;
+
+    // Shared between the worker and the parser.
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<std::string> queue;
+    bool finished = false;
+    bool stopped = false;
+    std::exception_ptr error;
+
+    // Owned by the parser: The data of the current block, of which the first handed_out bytes were returned.
+    std::string current;
+    size_t handed_out = 0;
+    bool any_block = false;
+
+    std::thread worker;
+};
+
+
+// Hands out the content of an input-file in blocks of complete lines. Plain files are memory-mapped and handed out as
+//  a single block. Compressed files (gzip, zstd or zip) are decompressed on a separate thread, see Decompressing_Reader.
+class Text_Input {
+public:
+    explicit Text_Input(const std::string& file_name): compression(detect_compression(file_name)) {
+        if (this->compression == Compression::None) {
+            this->mapped = std::make_unique<Mapped_File>(file_name);
+        } else {
+            this->decompressing = std::make_unique<Decompressing_Reader>(file_name, this->compression);
+        }
+    }
+
+    // Returns the next block, which is valid until the next call. Returns at least one (possibly empty) block.
+    bool next_block(std::string_view& block) {
+        if (this->decompressing) {return this->decompressing->next_block(block);}
+        if (this->handed_out) {return false;}
+        this->handed_out = true;
+        block = this->mapped->view();
+        return true;
+    }
+
+    [[nodiscard]] std::string description() const {
+        if (this->compression == Compression::None) {return "";}
+        return ", " + compression_name(this->compression) + "-compressed";
+    }
+
+private:
+    Compression compression;
+    std::unique_ptr<Mapped_File> mapped;
+    std::unique_ptr<Decompressing_Reader> decompressing;
+    bool handed_out = false;
+};
+
+
+// Writes a file, compressed as gzip or zstd or uncompressed. The data is handed over in chunks of any size, finish()
+//  writes the end of the compressed stream and must be called before the writer is destroyed.
+class Compressing_Writer {
+public:
+    Compressing_Writer(const std::string& file_name_, const Compression compression_):
+        file_name(file_name_), compression(compression_) {
+        if (this->compression == Compression::Zip) {
+            throw std::runtime_error("Zip-archives can only be read. Use gzip or zstd to write '" + this->file_name + "' compressed.");
+        }
+#ifndef GRAPHGENERATOR_WITH_ZLIB
+        if (this->compression == Compression::Gzip) {
+            throw std::runtime_error("Cannot write gzip-compressed file '" + this->file_name + "', the generator was built without zlib.");
+        }
+#endif
+#ifndef GRAPHGENERATOR_WITH_ZSTD
+        if (this->compression == Compression::Zstd) {
+            throw std::runtime_error("Cannot write zstd-compressed file '" + this->file_name + "', the generator was built without zstd.");
+        }
+#endif
+        this->file.open(this->file_name, std::ios::binary | std::ios::trunc);
+        if (!this->file.is_open()) {
+            throw std::runtime_error("Failed to open file " + this->file_name + " for writing.");
+        }
+#ifdef GRAPHGENERATOR_WITH_ZLIB
+        // 15 + 16: Maximum window size with a gzip-header.
+        if (this->compression == Compression::Gzip
+            && deflateInit2(&this->gzip_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw std::runtime_error("Could not initialize zlib.");
+        }
+#endif
+#ifdef GRAPHGENERATOR_WITH_ZSTD
+        if (this->compression == Compression::Zstd) {
+            this->zstd_stream = ZSTD_createCStream();
+            if (this->zstd_stream == nullptr) {throw std::runtime_error("Could not initialize zstd.");}
+        }
+#endif
+    }
+
+    ~Compressing_Writer() {
+#ifdef GRAPHGENERATOR_WITH_ZLIB
+        if (this->compression == Compression::Gzip) {deflateEnd(&this->gzip_stream);}
+#endif
+#ifdef GRAPHGENERATOR_WITH_ZSTD
+        if (this->zstd_stream != nullptr) {ZSTD_freeCStream(this->zstd_stream);}
+#endif
+    }
+
+    Compressing_Writer(const Compressing_Writer&) = delete;
+    Compressing_Writer& operator=(const Compressing_Writer&) = delete;
+
+    void write(const std::string_view data) {this->compress(data, false);}
+
+    void finish() {
+        this->compress({}, true);
+        this->file.close();
+        if (this->file.fail()) {throw std::runtime_error("Failed to write file " + this->file_name + ".");}
+    }
+
+private:
+    static constexpr size_t OUTPUT_BUFFER_SIZE = 1 << 20;
+
+    void compress(const std::string_view data, [[maybe_unused]] const bool last) {
+        if (this->compression == Compression::None) {
+            this->file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            return;
+        }
+#ifdef GRAPHGENERATOR_WITH_ZLIB
+        if (this->compression == Compression::Gzip) {
+            this->gzip_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+            this->gzip_stream.avail_in = static_cast<uInt>(data.size());
+            int result;
+            do {
+                this->gzip_stream.next_out = reinterpret_cast<Bytef*>(this->output.data());
+                this->gzip_stream.avail_out = static_cast<uInt>(this->output.size());
+                result = deflate(&this->gzip_stream, last ? Z_FINISH : Z_NO_FLUSH);
+                if (result == Z_STREAM_ERROR) {throw std::runtime_error("Could not compress file " + this->file_name + ".");}
+                this->file.write(this->output.data(), static_cast<std::streamsize>(this->output.size() - this->gzip_stream.avail_out));
+            } while (this->gzip_stream.avail_in > 0 || this->gzip_stream.avail_out == 0 || (last && result != Z_STREAM_END));
+        }
+#endif
+#ifdef GRAPHGENERATOR_WITH_ZSTD
+        if (this->compression == Compression::Zstd) {
+            ZSTD_inBuffer in_buffer = {data.data(), data.size(), 0};
+            size_t remaining;
+            do {
+                ZSTD_outBuffer out_buffer = {this->output.data(), this->output.size(), 0};
+                remaining = ZSTD_compressStream2(this->zstd_stream, &out_buffer, &in_buffer, last ? ZSTD_e_end : ZSTD_e_continue);
+                if (ZSTD_isError(remaining)) {
+                    throw std::runtime_error("Could not compress file " + this->file_name + ": " + ZSTD_getErrorName(remaining));
+                }
+                this->file.write(this->output.data(), static_cast<std::streamsize>(out_buffer.pos));
+            } while (in_buffer.pos < in_buffer.size || (last && remaining != 0));
+        }
+#endif
+    }
+
+    std::string file_name;
+    Compression compression;
+    std::ofstream file;
+    std::vector<char> output = std::vector<char>(OUTPUT_BUFFER_SIZE);
+#ifdef GRAPHGENERATOR_WITH_ZLIB
+    z_stream gzip_stream = {};
+#endif
+#ifdef GRAPHGENERATOR_WITH_ZSTD
+    ZSTD_CStream* zstd_stream = nullptr;
+#endif
+};
+
+#endif //GRAPHGENERATOR_COMPRESSED_H
@@ -0,0 +1,205 @@
+#ifndef GRAPHGENERATOR_EXTERNAL_SORT_H
+#define GRAPHGENERATOR_EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <cinttypes>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+// Sorts more records than fit into memory. Records are buffered until the memory budget is reached, the buffer is
+//  then sorted and written to a run-file. Once all records are added, the runs are merged while reading them back.
+//  Sorts in memory only, if no run had to be written.
+//
+// A Record must provide:
+//      bool operator<(const Record&) const;
+//      size_t memory_size() const;             // Approximate number of bytes used by the record in memory.
+//      void write(std::ostream&) const;
+//      bool read(std::istream&);               // Returns false at the end of the stream.
+template <typename Record>
+class External_Sorter {
+public:
+    // Run-files are named [run_prefix]_[n] and removed together with the sorter.
+    External_Sorter(std::filesystem::path run_prefix_, const size_t memory_budget_):
+        run_prefix(std::move(run_prefix_)), memory_budget(memory_budget_) {}
+
+    ~External_Sorter() {
+        this->inputs.clear();
+        std::error_code ignored;
+        for (const auto& run: this->runs) {std::filesystem::remove(run, ignored);}
+    }
+
+    External_Sorter(const External_Sorter&) = delete;
+    External_Sorter& operator=(const External_Sorter&) = delete;
+
+    void add(Record record) {
+        this->buffered_bytes += record.memory_size();
+        this->buffer.push_back(std::move(record));
+        if (this->buffered_bytes >= this->memory_budget) {this->spill();}
+    }
+
+    // Ends the input. The records can then be read in ascending order with next().
+    void finish() {
+        if (this->runs.empty()) {
+            std::sort(this->buffer.begin(), this->buffer.end());
+            return;
+        }
+        if (!this->buffer.empty()) {this->spill();}
+        this->buffer.shrink_to_fit();
+
+        // Keep the number of open files bounded by merging runs beforehand.
+        while (this->runs.size() > MAX_MERGE_WIDTH) {
+            std::vector<std::filesystem::path> merged_runs(this->runs.begin(), this->runs.begin() + MAX_MERGE_WIDTH);
+            this->runs.erase(this->runs.begin(), this->runs.begin() + MAX_MERGE_WIDTH);
+            this->open_runs(merged_runs);
+            const std::filesystem::path target = this->next_run_path();
+            {
+                std::ofstream output = open_output(target);
+                Record record;
+                while (this->next(record)) {record.write(output);}
+                output.flush();
+                if (!output.good()) {
+                    throw std::runtime_error("Could not write temporary file '" + target.string() + "'.");
+                }
+            }
+            this->inputs.clear();
+            for (const auto& run: merged_runs) {std::filesystem::remove(run);}
+            this->runs.push_back(target);
+        }
+        this->open_runs(this->runs);
+    }
+
+    // Returns the next record in ascending order, or false if all records were returned.
+    bool next(Record& record) {
+        if (this->inputs.empty()) {
+            if (this->buffer_position >= this->buffer.size()) {return false;}
+            record = std::move(this->buffer[this->buffer_position++]);
+            return true;
+        }
+        if (this->heads.empty()) {return false;}
+        std::pop_heap(this->heads.begin(), this->heads.end(), Head_Greater());
+        auto& head = this->heads.back();
+        record = std::move(head.first);
+        if (head.first.read(*this->inputs[head.second])) {
+            std::push_heap(this->heads.begin(), this->heads.end(), Head_Greater());
+        } else {
+            this->heads.pop_back();
+        }
+        return true;
+    }
+
+    // Writes the records, which are still held in memory after finish(), to a run. They are then read back through a
+    //  small buffer instead, which frees the memory for other sorters. Must be called before the first next().
+    void release_memory() {
+        if (!this->runs.empty() || this->buffer.empty()) {return;}
+        this->spill();
+        std::vector<Record>().swap(this->buffer);
+        this->open_runs(this->runs);
+    }
+
+    // Approximate number of bytes used by the records held in memory.
+    [[nodiscard]] size_t buffered_memory() const {return this->buffered_bytes;}
+    [[nodiscard]] size_t run_count() const {return this->runs.size();}
+
+private:
+    // Runs beyond this are merged into larger runs before reading.
+    static constexpr size_t MAX_MERGE_WIDTH = 64;
+    static constexpr size_t IO_BUFFER_SIZE = 1 << 16;
+
+    // Orders the heads of the runs as a min-heap.
+    struct Head_Greater {
+        bool operator()(const std::pair<Record, size_t>& a, const std::pair<Record, size_t>& b) const {
+            return b.first < a.first;
+        }
+    };
+
+    std::filesystem::path next_run_path() {
+        return this->run_prefix.string() + "_" + std::to_string(this->runs_created++);
+    }
+
+    static std::ofstream open_output(const std::filesystem::path& path) {
+        std::ofstream output(path, std::ios::binary);
+        if (!output.is_open()) {
+            throw std::runtime_error("Could not open temporary file '" + path.string() + "' for writing.");
+        }
+        return output;
+    }
+
+    void spill() {
+        std::sort(this->buffer.begin(), this->buffer.end());
+        const std::filesystem::path target = this->next_run_path();
+        std::ofstream output = open_output(target);
+        for (const Record& record: this->buffer) {record.write(output);}
+        // Flush before checking, so errors in writing the last buffered bytes are noticed as well.
+        output.flush();
+        if (!output.good()) {
+            throw std::runtime_error("Could not write temporary file '" + target.string() + "'.");
+        }
+        this->runs.push_back(target);
+        this->buffer.clear();
+        this->buffered_bytes = 0;
+    }
+
+    void open_runs(const std::vector<std::filesystem::path>& paths) {
+        this->inputs.clear();
+        this->heads.clear();
+        this->io_buffers.assign(paths.size(), std::vector<char>(IO_BUFFER_SIZE));
+        for (size_t i = 0; i < paths.size(); ++i) {
+            auto input = std::make_unique<std::ifstream>();
+            input->rdbuf()->pubsetbuf(this->io_buffers[i].data(), static_cast<std::streamsize>(IO_BUFFER_SIZE));
+            input->open(paths[i], std::ios::binary);
+            if (!input->is_open()) {
+                throw std::runtime_error("Could not open temporary file '" + paths[i].string() + "' for reading.");
+            }
+            Record record;
+            if (record.read(*input)) {this->heads.emplace_back(std::move(record), i);}
+            this->inputs.push_back(std::move(input));
+        }
+        std::make_heap(this->heads.begin(), this->heads.end(), Head_Greater());
+    }
+
+    std::filesystem::path run_prefix;
+    size_t memory_budget;
+
+    std::vector<Record> buffer;
+    size_t buffered_bytes = 0;
+    size_t buffer_position = 0;
+
+    std::vector<std::filesystem::path> runs;
+    size_t runs_created = 0;
+
+    // State of the merge: One open input and the current smallest record per run.
+    std::vector<std::unique_ptr<std::ifstream> > inputs;
+    std::vector<std::vector<char> > io_buffers;
+    std::vector<std::pair<Record, size_t> > heads;
+};
+
+
+// Helpers to write the fields of records in binary.
+template <typename T>
+void write_binary(std::ostream& output, const T& value) {
+    output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read_binary(std::istream& input, T& value) {
+    return static_cast<bool>(input.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+inline void write_binary_string(std::ostream& output, const std::string& value) {
+    write_binary(output, static_cast<std::uint32_t>(value.size()));
+    output.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+inline bool read_binary_string(std::istream& input, std::string& value) {
+    std::uint32_t size;
+    if (!read_binary(input, size)) {return false;}
+    value.resize(size);
+    return static_cast<bool>(input.read(value.data(), size));
+}
+
+#endif //GRAPHGENERATOR_EXTERNAL_SORT_H
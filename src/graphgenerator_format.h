@@ -0,0 +1,51 @@
+#ifndef GRAPHGENERATOR_FORMAT_H
+#define GRAPHGENERATOR_FORMAT_H
+
+#include <bit>
+#include <cinttypes>
+
+// Two decimal digits per entry. Allows writing two digits per division.
+constexpr char DIGIT_PAIRS[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+constexpr std::uint64_t POWERS_OF_10[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+// Number of decimal digits of a 64-bit uint. log10(x) is approximated from the bit width by 1233/4096 ~ log10(2)
+//  and corrected with a single comparison. Setting the lowest bit never crosses a power of 10, but maps 0 to 1 digit.
+inline int count_u64_digits(const std::uint64_t value) {
+    const int approximation = (std::bit_width(value | 1) * 1233) >> 12;
+    return approximation + ((value | 1) >= POWERS_OF_10[approximation]);
+}
+
+// Custom Int-to-(ASCII)-String function. Allows only unsigned 64-bit integers in base10.
+//     Safety-Checks removed, use at your own peril! The target needs space for at least 21 chars.
+// The length is predicted first, so the digits are written directly into place, two at a time, back to front.
+inline int unsafe_u64Int_to_str(char* sp, std::uint64_t value) {
+    const int len = count_u64_digits(value);
+    char* tp = sp + len;
+    *tp = '\0';
+
+    while (value >= 100) {
+        const std::uint64_t pair = (value % 100) * 2;
+        value /= 100;
+        *--tp = DIGIT_PAIRS[pair + 1];
+        *--tp = DIGIT_PAIRS[pair];
+    }
+    if (value >= 10) {
+        *--tp = DIGIT_PAIRS[value * 2 + 1];
+        *--tp = DIGIT_PAIRS[value * 2];
+    } else {
+        *--tp = static_cast<char>('0' + value);
+    }
+
+    return len;
+}
+
+#endif //GRAPHGENERATOR_FORMAT_H
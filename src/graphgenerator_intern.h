@@ -0,0 +1,362 @@
+#ifndef GRAPHGENERATOR_INTERN_H
+#define GRAPHGENERATOR_INTERN_H
+
+#include <algorithm>
+#include <charconv>
+#include <cinttypes>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Dense IDs of the nodes of an input graph, assigned in the order in which the nodes are first seen.
+using Dense_NodeID = std::uint32_t;
+
+
+// Interns the names of nodes into dense IDs. The names are stored back-to-back in a single arena and looked up
+//  through an open-addressing hash table with linear probing. Compared to a map keyed by std::string, this avoids
+//  one allocation per node and keeps lookups within two flat arrays.
+class Node_Name_Table {
+public:
+    static constexpr Dense_NodeID NOT_FOUND = std::numeric_limits<Dense_NodeID>::max();
+
+    Node_Name_Table() {this->slots.assign(INITIAL_CAPACITY, EMPTY_SLOT);}
+
+    // Returns the ID of the given name, or NOT_FOUND for unknown names.
+    [[nodiscard]] Dense_NodeID find(const std::string_view name) const {
+        const std::uint64_t hash = std::hash<std::string_view>{}(name);
+        for (size_t slot = hash & (this->slots.size() - 1);; slot = (slot + 1) & (this->slots.size() - 1)) {
+            const Dense_NodeID entry = this->slots[slot];
+            if (entry == EMPTY_SLOT) {return NOT_FOUND;}
+            if (this->hashes[entry] == hash && this->name(entry) == name) {return entry;}
+        }
+    }
+
+    // Returns the ID of the given name. Unknown names are inserted with the next free ID, which is flagged by second.
+    std::pair<Dense_NodeID, bool> intern(const std::string_view name) {
+        const std::uint64_t hash = std::hash<std::string_view>{}(name);
+        size_t slot = hash & (this->slots.size() - 1);
+        for (;; slot = (slot + 1) & (this->slots.size() - 1)) {
+            const Dense_NodeID entry = this->slots[slot];
+            if (entry == EMPTY_SLOT) {break;}
+            if (this->hashes[entry] == hash && this->name(entry) == name) {return {entry, false};}
+        }
+
+        if (this->hashes.size() >= NOT_FOUND - 1) {
+            throw std::runtime_error("The input graph has more nodes than can be represented by a Dense_NodeID.");
+        }
+        const auto id = static_cast<Dense_NodeID>(this->hashes.size());
+        this->arena.insert(this->arena.end(), name.begin(), name.end());
+        this->offsets.push_back(this->arena.size());
+        this->hashes.push_back(hash);
+        this->slots[slot] = id;
+
+        // Keep the load factor at or below 1/2.
+        if (2 * this->hashes.size() > this->slots.size()) {this->grow();}
+        return {id, true};
+    }
+
+    [[nodiscard]] std::string_view name(const Dense_NodeID id) const {
+        return {this->arena.data() + this->offsets[id], this->offsets[id + 1] - this->offsets[id]};
+    }
+
+    [[nodiscard]] size_t size() const {return this->hashes.size();}
+
+private:
+    static constexpr Dense_NodeID EMPTY_SLOT = NOT_FOUND;
+    static constexpr size_t INITIAL_CAPACITY = 1024;    // Must be a power of 2.
+
+    void grow() {
+        this->slots.assign(2 * this->slots.size(), EMPTY_SLOT);
+        for (Dense_NodeID id = 0; id < this->hashes.size(); ++id) {
+            size_t slot = this->hashes[id] & (this->slots.size() - 1);
+            while (this->slots[slot] != EMPTY_SLOT) {slot = (slot + 1) & (this->slots.size() - 1);}
+            this->slots[slot] = id;
+        }
+    }
+
+    std::vector<char> arena;
+    std::vector<std::uint64_t> offsets = {0};   // Name i is stored in arena[offsets[i], offsets[i+1]).
+    std::vector<std::uint64_t> hashes;          // Cached hash of every name, used for comparisons and growing.
+    std::vector<Dense_NodeID> slots;
+};
+
+
+// Interns unsigned integer node-IDs into dense IDs. Same layout as the Node_Name_Table, but the IDs are compared as
+//  numbers. Lookups of IDs within a dense range can bypass the hash table through a direct array.
+class Node_Number_Table {
+public:
+    Node_Number_Table() {this->slots.assign(INITIAL_CAPACITY, EMPTY_SLOT);}
+
+    [[nodiscard]] Dense_NodeID find(const std::uint64_t number) const {
+        if (number < this->direct.size()) {return this->direct[number];}
+        for (size_t slot = mix(number) & (this->slots.size() - 1);; slot = (slot + 1) & (this->slots.size() - 1)) {
+            const Dense_NodeID entry = this->slots[slot];
+            if (entry == EMPTY_SLOT || this->numbers[entry] == number) {return entry;}
+        }
+    }
+
+    std::pair<Dense_NodeID, bool> intern(const std::uint64_t number) {
+        size_t slot = mix(number) & (this->slots.size() - 1);
+        for (;; slot = (slot + 1) & (this->slots.size() - 1)) {
+            const Dense_NodeID entry = this->slots[slot];
+            if (entry == EMPTY_SLOT) {break;}
+            if (this->numbers[entry] == number) {return {entry, false};}
+        }
+
+        if (this->numbers.size() >= EMPTY_SLOT - 1) {
+            throw std::runtime_error("The input graph has more nodes than can be represented by a Dense_NodeID.");
+        }
+        const auto id = static_cast<Dense_NodeID>(this->numbers.size());
+        this->numbers.push_back(number);
+        this->slots[slot] = id;
+        if (number < this->direct.size()) {this->direct[number] = id;}
+
+        if (2 * this->numbers.size() > this->slots.size()) {this->grow();}
+        return {id, true};
+    }
+
+    // Builds the direct array if the IDs cover a dense range, i.e. if it needs at most DIRECT_ARRAY_SPREAD entries per
+    //  node. Otherwise, lookups keep using the hash table.
+    void build_direct_array() {
+        std::uint64_t highest = 0;
+        for (const auto number: this->numbers) {highest = std::max(highest, number);}
+        if (this->numbers.empty() || highest >= DIRECT_ARRAY_SPREAD * this->numbers.size() + DIRECT_ARRAY_SLACK) {
+            this->direct.clear();
+            return;
+        }
+        this->direct.assign(highest + 1, EMPTY_SLOT);
+        for (Dense_NodeID id = 0; id < this->numbers.size(); ++id) {this->direct[this->numbers[id]] = id;}
+    }
+
+    [[nodiscard]] std::uint64_t number(const Dense_NodeID id) const {return this->numbers[id];}
+    [[nodiscard]] size_t size() const {return this->numbers.size();}
+    [[nodiscard]] bool has_direct_array() const {return !this->direct.empty();}
+
+private:
+    static constexpr Dense_NodeID EMPTY_SLOT = std::numeric_limits<Dense_NodeID>::max();
+    static constexpr size_t INITIAL_CAPACITY = 1024;    // Must be a power of 2.
+    static constexpr std::uint64_t DIRECT_ARRAY_SPREAD = 2;
+    static constexpr std::uint64_t DIRECT_ARRAY_SLACK = 1 << 16;
+
+    // Fibonacci-hashing. Consecutive IDs are spread over the table instead of forming long runs.
+    static std::uint64_t mix(const std::uint64_t number) {
+        const std::uint64_t product = number * 0x9E3779B97F4A7C15ULL;
+        return product ^ (product >> 32);
+    }
+
+    void grow() {
+        this->slots.assign(2 * this->slots.size(), EMPTY_SLOT);
+        for (Dense_NodeID id = 0; id < this->numbers.size(); ++id) {
+            size_t slot = mix(this->numbers[id]) & (this->slots.size() - 1);
+            while (this->slots[slot] != EMPTY_SLOT) {slot = (slot + 1) & (this->slots.size() - 1);}
+            this->slots[slot] = id;
+        }
+    }
+
+    std::vector<std::uint64_t> numbers;     // Node-ID of every dense ID.
+    std::vector<Dense_NodeID> slots;
+    std::vector<Dense_NodeID> direct;       // Dense ID of every node-ID in [0, direct.size()), empty if not built.
+};
+
+
+// How node-IDs are interpreted when reading a graph.
+//  Text:    IDs are arbitrary strings.
+//  Numeric: IDs are unsigned integers, which are parsed as numbers. Lines with other IDs are skipped.
+//  Auto:    IDs are parsed as numbers as long as all of them are canonical integers (no sign or leading zeros), which
+//              preserves the semantics of Text. The first other ID switches to Text.
+enum class Node_ID_Mode {
+    Auto,
+    Numeric,
+    Text
+};
+
+
+// Interns node-IDs into dense IDs, either as text or as numbers depending on the Node_ID_Mode.
+class Node_Index {
+public:
+    explicit Node_Index(const Node_ID_Mode mode_ = Node_ID_Mode::Auto): mode(mode_), numeric(mode_ != Node_ID_Mode::Text) {}
+
+    [[nodiscard]] Node_ID_Mode id_mode() const {return this->mode;}
+    [[nodiscard]] bool is_numeric() const {return this->numeric;}
+
+    // False if the node-ID can never be interned, i.e. if it is not an integer in Numeric mode.
+    [[nodiscard]] bool accepts(const std::string_view node) const {
+        std::uint64_t number;
+        return this->mode != Node_ID_Mode::Numeric || parse_number(node, false, number);
+    }
+
+    // Returns the dense ID of the given node-ID, or NOT_FOUND for unknown IDs.
+    [[nodiscard]] Dense_NodeID find(const std::string_view node) const {
+        if (!this->numeric) {return this->names.find(node);}
+        std::uint64_t number;
+        if (!parse_number(node, this->mode == Node_ID_Mode::Auto, number)) {return NOT_FOUND;}
+        return this->numbers.find(number);
+    }
+
+    // Returns the dense ID of the given node-ID, which is added if necessary. Returns NOT_FOUND for IDs that are
+    //  not accepted.
+    std::pair<Dense_NodeID, bool> intern(const std::string_view node) {
+        if (this->numeric) {
+            std::uint64_t number;
+            if (parse_number(node, this->mode == Node_ID_Mode::Auto, number)) {return this->numbers.intern(number);}
+            if (this->mode == Node_ID_Mode::Numeric) {return {NOT_FOUND, false};}
+            this->switch_to_text();
+        }
+        return this->names.intern(node);
+    }
+
+    // Interns the node with the given dense ID of another index. Avoids the conversion to text where possible.
+    std::pair<Dense_NodeID, bool> intern_from(const Node_Index& other, const Dense_NodeID id) {
+        if (this->numeric && other.numeric) {return this->numbers.intern(other.numbers.number(id));}
+        if (!other.numeric) {return this->intern(other.names.name(id));}
+        return this->intern(other.name(id));
+    }
+
+    [[nodiscard]] std::string name(const Dense_NodeID id) const {
+        if (!this->numeric) {return std::string(this->names.name(id));}
+        char buffer[24];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), this->numbers.number(id));
+        return {buffer, result.ptr};
+    }
+
+    [[nodiscard]] size_t size() const {return this->numeric ? this->numbers.size() : this->names.size();}
+
+    // Speeds up later lookups of numeric IDs with a direct array, if they cover a dense range.
+    void optimize_lookups() {
+        if (this->numeric) {this->numbers.build_direct_array();}
+    }
+    [[nodiscard]] bool has_direct_lookups() const {return this->numeric && this->numbers.has_direct_array();}
+
+private:
+    // Parses the whole string as an unsigned integer. Canonical numbers must not have leading zeros.
+    static bool parse_number(const std::string_view node, const bool canonical, std::uint64_t& number) {
+        if (node.empty() || (canonical && node.size() > 1 && node.front() == '0')) {return false;}
+        const auto result = std::from_chars(node.data(), node.data() + node.size(), number);
+        return result.ec == std::errc() && result.ptr == node.data() + node.size();
+    }
+
+    // Re-interns all numeric IDs as text. The dense IDs are kept.
+    void switch_to_text() {
+        this->numeric = false;
+        for (Dense_NodeID id = 0; id < this->numbers.size(); ++id) {
+            char buffer[24];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), this->numbers.number(id));
+            this->names.intern(std::string_view(buffer, result.ptr - buffer));
+        }
+        this->numbers = Node_Number_Table();
+    }
+
+    static constexpr Dense_NodeID NOT_FOUND = Node_Name_Table::NOT_FOUND;
+
+    Node_ID_Mode mode;
+    bool numeric;
+    Node_Name_Table names;
+    Node_Number_Table numbers;
+};
+
+
+// IDs of node- and edge-types, assigned in the order in which the types are first seen.
+using Type_ID = std::uint32_t;
+
+
+// Interns node- or edge-types into small IDs. A type may be composed of several columns, which are joined by
+//  underscores. Composite types are hashed and compared column by column, so the joined string is only built once
+//  per distinct type.
+class Type_Table {
+public:
+    static constexpr Type_ID NOT_FOUND = std::numeric_limits<Type_ID>::max();
+
+    Type_Table() {this->slots.assign(INITIAL_CAPACITY, NOT_FOUND);}
+
+    // Returns the ID of the type composed of columns[indices[0]], columns[indices[1]], ... Unknown types are added.
+    Type_ID intern(const std::span<const std::string_view> columns, const std::span<const size_t> indices) {
+        const std::uint64_t hash = hash_composite(columns, indices);
+        size_t slot = hash & (this->slots.size() - 1);
+        for (;; slot = (slot + 1) & (this->slots.size() - 1)) {
+            const Type_ID entry = this->slots[slot];
+            if (entry == NOT_FOUND) {break;}
+            if (this->hashes[entry] == hash && equals_composite(this->names[entry], columns, indices)) {return entry;}
+        }
+
+        std::string name;
+        for (size_t i = 0; i < indices.size(); ++i) {
+            if (i > 0) {name.push_back('_');}
+            name.append(columns[indices[i]]);
+        }
+        const auto id = static_cast<Type_ID>(this->names.size());
+        this->names.push_back(std::move(name));
+        this->hashes.push_back(hash);
+        this->slots[slot] = id;
+
+        if (2 * this->names.size() > this->slots.size()) {this->grow();}
+        return id;
+    }
+
+    Type_ID intern(const std::string_view type) {
+        constexpr size_t first_index[1] = {0};
+        return this->intern(std::span<const std::string_view>(&type, 1), first_index);
+    }
+
+    [[nodiscard]] Type_ID find(const std::string_view type) const {
+        constexpr size_t first_index[1] = {0};
+        const std::uint64_t hash = hash_composite(std::span<const std::string_view>(&type, 1), first_index);
+        for (size_t slot = hash & (this->slots.size() - 1);; slot = (slot + 1) & (this->slots.size() - 1)) {
+            const Type_ID entry = this->slots[slot];
+            if (entry == NOT_FOUND || (this->hashes[entry] == hash && this->names[entry] == type)) {return entry;}
+        }
+    }
+
+    [[nodiscard]] const std::string& name(const Type_ID id) const {return this->names[id];}
+    [[nodiscard]] size_t size() const {return this->names.size();}
+
+private:
+    static constexpr size_t INITIAL_CAPACITY = 16;    // Must be a power of 2.
+
+    // FNV-1a over the joined type, without joining it.
+    static std::uint64_t hash_composite(const std::span<const std::string_view> columns, const std::span<const size_t> indices) {
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        bool first = true;
+        for (const auto idx: indices) {
+            if (!first) {hash = (hash ^ static_cast<unsigned char>('_')) * 0x100000001b3ULL;}
+            for (const char c: columns[idx]) {hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;}
+            first = false;
+        }
+        return hash;
+    }
+
+    static bool equals_composite(const std::string_view name, const std::span<const std::string_view> columns,
+        const std::span<const size_t> indices) {
+        size_t pos = 0;
+        bool first = true;
+        for (const auto idx: indices) {
+            if (!first) {
+                if (pos >= name.size() || name[pos] != '_') {return false;}
+                ++pos;
+            }
+            if (name.substr(pos, columns[idx].size()) != columns[idx]) {return false;}
+            pos += columns[idx].size();
+            first = false;
+        }
+        return pos == name.size();
+    }
+
+    void grow() {
+        this->slots.assign(2 * this->slots.size(), NOT_FOUND);
+        for (Type_ID id = 0; id < this->names.size(); ++id) {
+            size_t slot = this->hashes[id] & (this->slots.size() - 1);
+            while (this->slots[slot] != NOT_FOUND) {slot = (slot + 1) & (this->slots.size() - 1);}
+            this->slots[slot] = id;
+        }
+    }
+
+    std::vector<std::string> names;
+    std::vector<std::uint64_t> hashes;
+    std::vector<Type_ID> slots;
+};
+
+#endif //GRAPHGENERATOR_INTERN_H
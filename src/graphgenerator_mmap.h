@@ -0,0 +1,86 @@
+#ifndef GRAPHGENERATOR_MMAP_H
+#define GRAPHGENERATOR_MMAP_H
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GRAPHGENERATOR_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define GRAPHGENERATOR_HAS_MMAP 0
+#endif
+
+
+// Read-only view of a whole file. The file is memory-mapped where possible, otherwise it is read into memory once.
+//  The content is only valid as long as the object exists.
+class Mapped_File {
+public:
+    explicit Mapped_File(const std::string& file_name) {
+#if GRAPHGENERATOR_HAS_MMAP
+        this->fd = ::open(file_name.c_str(), O_RDONLY);
+        if (this->fd < 0) {
+            throw std::runtime_error("Could not open file '" + file_name + "' for reading.");
+        }
+        struct stat file_stat = {};
+        if (::fstat(this->fd, &file_stat) != 0) {
+            ::close(this->fd);
+            throw std::runtime_error("Could not determine the size of file '" + file_name + "'.");
+        }
+        this->length = static_cast<size_t>(file_stat.st_size);
+
+        // Empty files can not be mapped.
+        if (this->length > 0) {
+            void* mapping = ::mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, this->fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(this->fd);
+                throw std::runtime_error("Could not memory-map file '" + file_name + "'.");
+            }
+            ::madvise(mapping, this->length, MADV_SEQUENTIAL);
+            this->mapped = static_cast<const char*>(mapping);
+        }
+#else
+        std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file '" + file_name + "' for reading.");
+        }
+        this->fallback_buffer.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(this->fallback_buffer.data(), static_cast<std::streamsize>(this->fallback_buffer.size()));
+        this->mapped = this->fallback_buffer.data();
+        this->length = this->fallback_buffer.size();
+#endif
+    }
+
+    ~Mapped_File() {
+#if GRAPHGENERATOR_HAS_MMAP
+        if (this->mapped != nullptr) {::munmap(const_cast<char*>(this->mapped), this->length);}
+        if (this->fd >= 0) {::close(this->fd);}
+#endif
+    }
+
+    Mapped_File(const Mapped_File&) = delete;
+    Mapped_File& operator=(const Mapped_File&) = delete;
+
+    [[nodiscard]] const char* data() const {return this->mapped;}
+    [[nodiscard]] size_t size() const {return this->length;}
+    [[nodiscard]] std::string_view view() const {return {this->mapped, this->length};}
+
+private:
+    const char* mapped = nullptr;
+    size_t length = 0;
+#if GRAPHGENERATOR_HAS_MMAP
+    int fd = -1;
+#else
+    std::vector<char> fallback_buffer;
+#endif
+};
+
+#endif //GRAPHGENERATOR_MMAP_H
@@ -0,0 +1,43 @@
+#ifndef GRAPHGENERATOR_PARALLEL_H
+#define GRAPHGENERATOR_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Runs task(i) for every i in [0, n_tasks) on all available threads. Tasks are handed out in order of their index.
+//  If tasks throw, no further tasks are started and the exception of the failed task with the lowest index is
+//  rethrown on the calling thread once all threads are joined, i.e. the exception a sequential loop would throw.
+template <typename Function>
+void run_tasks_in_parallel(const size_t n_tasks, const Function& task) {
+    const size_t n_threads = std::min<size_t>(std::max(1U, std::thread::hardware_concurrency()), n_tasks);
+    std::atomic<size_t> next_task = 0;
+    std::mutex failure_lock;
+    size_t failed_task = n_tasks;
+    std::exception_ptr failure;
+    auto worker = [&]() {
+        for (size_t i = next_task++; i < n_tasks; i = next_task++) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(failure_lock);
+                if (i < failed_task) {
+                    failed_task = i;
+                    failure = std::current_exception();
+                }
+                next_task = n_tasks;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < n_threads; ++i) {threads.emplace_back(worker);}
+    worker();
+    for (auto& thread: threads) {thread.join();}
+    if (failure) {std::rethrow_exception(failure);}
+}
+
+#endif //GRAPHGENERATOR_PARALLEL_H
@@ -0,0 +1,74 @@
+#ifndef GRAPHGENERATOR_RADIX_H
+#define GRAPHGENERATOR_RADIX_H
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <thread>
+#include <vector>
+
+
+// Keys below this are sorted by a single thread.
+constexpr size_t MIN_KEYS_PER_RADIX_THREAD = 1 << 16;
+
+
+// Sorts 64-bit keys ascending with a least-significant-digit radix sort of 8 bits per pass. Bytes that are equal in
+//  all keys are skipped, so keys that only use their lowest bits need few passes. Every pass counts the digits of
+//  a chunk of keys per thread first, then each thread scatters its chunk to the offsets derived from all counts.
+inline void parallel_radix_sort(std::vector<std::uint64_t>& keys, size_t n_threads) {
+    if (keys.size() < 2) {return;}
+    n_threads = std::clamp<size_t>(keys.size() / MIN_KEYS_PER_RADIX_THREAD, 1, std::max<size_t>(n_threads, 1));
+
+    std::uint64_t any_set = 0;
+    std::uint64_t all_set = ~std::uint64_t{0};
+    for (const std::uint64_t key: keys) {
+        any_set |= key;
+        all_set &= key;
+    }
+    const std::uint64_t varying = any_set ^ all_set;
+
+    std::vector<size_t> chunks;
+    for (size_t i = 0; i <= n_threads; ++i) {chunks.push_back(keys.size() * i / n_threads);}
+
+    // Runs the given function for every chunk, on its own thread.
+    auto for_each_chunk = [&](const auto& function) {
+        if (n_threads == 1) {
+            function(0);
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < n_threads; ++i) {threads.emplace_back(function, i);}
+        for (auto& thread: threads) {thread.join();}
+    };
+
+    std::vector<std::uint64_t> buffer(keys.size());
+    std::vector<std::array<size_t, 256> > offsets(n_threads);
+    for (int shift = 0; shift < 64; shift += 8) {
+        if (((varying >> shift) & 0xFF) == 0) {continue;}
+
+        for_each_chunk([&](const size_t chunk) {
+            offsets[chunk].fill(0);
+            for (size_t i = chunks[chunk]; i < chunks[chunk + 1]; ++i) {++offsets[chunk][(keys[i] >> shift) & 0xFF];}
+        });
+
+        // Each digit is placed after all smaller digits, the keys of a digit in the order of the chunks.
+        size_t position = 0;
+        for (size_t digit = 0; digit < 256; ++digit) {
+            for (size_t chunk = 0; chunk < n_threads; ++chunk) {
+                const size_t count = offsets[chunk][digit];
+                offsets[chunk][digit] = position;
+                position += count;
+            }
+        }
+
+        for_each_chunk([&](const size_t chunk) {
+            auto& chunk_offsets = offsets[chunk];
+            for (size_t i = chunks[chunk]; i < chunks[chunk + 1]; ++i) {
+                buffer[chunk_offsets[(keys[i] >> shift) & 0xFF]++] = keys[i];
+            }
+        });
+        keys.swap(buffer);
+    }
+}
+
+#endif //GRAPHGENERATOR_RADIX_H
@@ -0,0 +1,93 @@
+#ifndef GRAPHGENERATOR_SIMD_H
+#define GRAPHGENERATOR_SIMD_H
+
+#include <bit>
+#include <cinttypes>
+#include <limits>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+// Bitmask of all tabs and newlines within the 64 bytes starting at data. Bit i is set if data[i] is a delimiter.
+//  Uses AVX2 or SSE2 where available (selected by -march), otherwise a scalar loop.
+inline std::uint64_t delimiter_mask_64(const char* data) {
+#if defined(__AVX2__)
+    const __m256i tabs = _mm256_set1_epi8('\t');
+    const __m256i newlines = _mm256_set1_epi8('\n');
+    const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+    const auto mask_low = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(low, tabs), _mm256_cmpeq_epi8(low, newlines))));
+    const auto mask_high = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(high, tabs), _mm256_cmpeq_epi8(high, newlines))));
+    return (static_cast<std::uint64_t>(mask_high) << 32) | mask_low;
+#elif defined(__SSE2__)
+    const __m128i tabs = _mm_set1_epi8('\t');
+    const __m128i newlines = _mm_set1_epi8('\n');
+    std::uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i));
+        const auto chunk_mask = static_cast<std::uint16_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, tabs), _mm_cmpeq_epi8(chunk, newlines))));
+        mask |= static_cast<std::uint64_t>(chunk_mask) << (16 * i);
+    }
+    return mask;
+#else
+    std::uint64_t mask = 0;
+    for (int i = 0; i < 64; ++i) {
+        mask |= static_cast<std::uint64_t>(data[i] == '\t' || data[i] == '\n') << i;
+    }
+    return mask;
+#endif
+}
+
+
+// Finds the delimiters (tabs and newlines) of a buffer in blocks of 64 bytes. The positions of the delimiters within
+//  the current block are kept as a bitmask, so finding the next delimiter is usually a single count of trailing zeros.
+//  The last bytes of the buffer, which do not fill a full block, are scanned without SIMD to avoid reading past its end.
+class Delimiter_Scanner {
+public:
+    explicit Delimiter_Scanner(const std::string_view buffer_): buffer(buffer_) {}
+
+    // Position of the next delimiter at or after pos. Returns the size of the buffer if there is none.
+    //  Consecutive calls are fastest with increasing positions.
+    size_t next(size_t pos) {
+        while (pos < this->buffer.size()) {
+            if (pos < this->block_start || pos >= this->block_start + 64) {
+                this->load_block(pos);
+            }
+            // Disregard all delimiters before pos in the current block.
+            const std::uint64_t remaining = this->mask & (~std::uint64_t{0} << (pos - this->block_start));
+            if (remaining != 0) {
+                return this->block_start + static_cast<size_t>(std::countr_zero(remaining));
+            }
+            pos = this->block_start + 64;
+        }
+        return this->buffer.size();
+    }
+
+private:
+    void load_block(const size_t pos) {
+        this->block_start = pos;
+        if (pos + 64 <= this->buffer.size()) {
+            this->mask = delimiter_mask_64(this->buffer.data() + pos);
+            return;
+        }
+        this->mask = 0;
+        for (size_t i = pos; i < this->buffer.size(); ++i) {
+            const char c = this->buffer[i];
+            this->mask |= static_cast<std::uint64_t>(c == '\t' || c == '\n') << (i - pos);
+        }
+    }
+
+    static constexpr size_t NO_BLOCK = std::numeric_limits<size_t>::max() - 64;
+
+    std::string_view buffer;
+    size_t block_start = NO_BLOCK;     // Start of the currently loaded block.
+    std::uint64_t mask = 0;
+};
+
+#endif //GRAPHGENERATOR_SIMD_H
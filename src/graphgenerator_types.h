@@ -3,14 +3,88 @@
 
 #include <cmath>
 #include <cinttypes>
+#include <compare>
+#include <limits>
+#include <stdexcept>
 #include <string>
 
 using NodeID = std::uint64_t;
-using ContinuousNodeID = long double;
+
+// Continuous NodeIDs are 64-bit fixed-point numbers with FRACTION_BITS binary digits after the point, which limits
+//  NodeIDs to 2^40, larger IDs are rejected. Real values are rounded to the nearest fixed-point value with the same
+//  integer part, so the NodeIDs of a range, which are recovered from the integer part, are always the exact ones.
+//  Every value converts to a long double without loss.
+class Fixed_Point_ID {
+public:
+    static constexpr unsigned FRACTION_BITS = 24;
+    static constexpr std::uint64_t ONE = std::uint64_t(1) << FRACTION_BITS;
+    static constexpr NodeID MAX_INTEGER = std::numeric_limits<std::uint64_t>::max() >> FRACTION_BITS;
+
+    constexpr Fixed_Point_ID() = default;
+
+    // Integers are represented exactly.
+    constexpr Fixed_Point_ID(const NodeID integer): raw(integer << FRACTION_BITS) {
+        if (integer > MAX_INTEGER) {throw_out_of_range();}
+    }
+
+    static Fixed_Point_ID from_real(const long double value) {
+        const NodeID integer = integer_part_of(value);
+        // The product is exact, as is the difference to its floor. Rounding up never carries into the integer part.
+        const long double fraction = value * ONE - static_cast<long double>(integer) * ONE;
+        std::uint64_t fraction_raw = static_cast<std::uint64_t>(fraction);
+        if (fraction - static_cast<long double>(fraction_raw) >= 0.5L && fraction_raw < ONE - 1) {++fraction_raw;}
+        return from_raw((integer << FRACTION_BITS) + fraction_raw);
+    }
+
+    // The integer part of a real value, as the NodeIDs of a range are recovered from it. Used on products of scaling
+    //  before they are rounded to a fixed-point value.
+    static NodeID integer_part_of(const long double value) {
+        if (!(value >= 0) || value >= static_cast<long double>(MAX_INTEGER) + 1) {throw_out_of_range();}
+        return static_cast<NodeID>(value);
+    }
+
+    static constexpr Fixed_Point_ID from_raw(const std::uint64_t raw_value) {
+        Fixed_Point_ID id;
+        id.raw = raw_value;
+        return id;
+    }
+
+    static constexpr Fixed_Point_ID max() {return from_raw(std::numeric_limits<std::uint64_t>::max());}
+
+    [[nodiscard]] constexpr NodeID integer_part() const {return this->raw >> FRACTION_BITS;}
+    [[nodiscard]] constexpr std::uint64_t fraction() const {return this->raw & (ONE - 1);}
+    [[nodiscard]] constexpr std::uint64_t raw_value() const {return this->raw;}
+    [[nodiscard]] constexpr long double to_real() const {return static_cast<long double>(this->raw) / ONE;}
+
+    constexpr auto operator<=>(const Fixed_Point_ID&) const = default;
+
+private:
+    [[noreturn]] static void throw_out_of_range() {
+        throw std::runtime_error("NodeIDs of the model must lie between 0 and " + std::to_string(MAX_INTEGER) + ".");
+    }
+
+    std::uint64_t raw = 0;
+};
+
+using ContinuousNodeID = Fixed_Point_ID;
 using Amount = std::uint64_t;
 using Degree = std::uint64_t;
 using Probability = std::float_t;
 using Edge_Type = std::string;
 using Node_Type = std::string;
 
+// How the degrees of the nodes are counted while reading a graph. Records increments the degrees of a node for every
+//  edge, Sort collects the endpoints of all edges and counts the degrees by sorting them.
+enum class Degree_Aggregation {Records, Sort};
+
+// Degrees may be grouped into classes before the model is built, which bounds the number of blocks. Logarithmic
+//  classes span a constant ratio of degrees, Count spans as many logarithmic classes as given between the lowest
+//  and the highest degree of every distribution.
+enum class Degree_Binning {None, Logarithmic, Count};
+struct Degree_Classes {
+    Degree_Binning binning = Degree_Binning::None;
+    long double ratio = 2.0;        // For Logarithmic classes.
+    std::size_t count = 0;          // For Count classes.
+};
+
 #endif //GRAPHGENERATOR_TYPES_H
@@ -0,0 +1,278 @@
+/*
+ *  Binary form of the m1-format. Models are written with -save to files ending in '.m1b' and loaded with -load, which
+ *  tells both forms apart by their first bytes. The blocks are stored in the layout used in memory, so a loaded model
+ *  uses them in place from the memory-mapped file without parsing.
+ *
+ *  Layout (native byte order, all offsets from the start of the file):
+ *      Header              magic, version, byte order, sizes of the records and the counts of all sections below.
+ *      String table        [u32 length][bytes] per string. Holds the name, meta-data and all types, each once.
+ *      Meta                [u32 key][u32 value] per entry, as indices into the string table.
+ *      Nodes               [Binary_Node] per node-record.
+ *      Edge table          [Binary_Edge_Type] per edge-type.
+ *      Blocks              The Edge_Blocks of every edge-type, each array aligned to BINARY_BLOCK_ALIGNMENT.
+ *
+ *  IDs are stored as 64-bit fixed-point values, files are thus read on all platforms with the same byte order. Use the
+ *  text form to exchange models between others.
+ */
+
+#include "../src/graphgenerator_mmap.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+constexpr char BINARY_MODEL_MAGIC[8] = {'m', '1', 'b', 'i', 'n', 'a', 'r', 'y'};
+constexpr std::uint32_t BINARY_MODEL_VERSION = 2;
+constexpr std::uint32_t BINARY_BYTE_ORDER_MARK = 0x01020304;
+constexpr size_t BINARY_BLOCK_ALIGNMENT = 64;
+constexpr size_t BINARY_BLOCK_CHUNK = 1 << 16;
+
+struct Binary_Model_Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t block_size;       // sizeof(Edge_Block)
+    std::uint32_t id_fraction_bits; // Binary digits after the point of a ContinuousNodeID.
+    std::uint64_t file_size;
+    std::uint64_t n_strings;
+    std::uint64_t n_meta;
+    std::uint64_t n_nodes;
+    std::uint64_t n_edge_types;
+};
+
+struct Binary_Node {
+    ContinuousNodeID startID;
+    ContinuousNodeID endID;
+    std::uint32_t node_type;
+};
+
+struct Binary_Edge_Type {
+    std::uint32_t edge_type;
+    std::uint32_t reserved;
+    std::uint64_t n_blocks;
+    std::uint64_t offset;
+};
+
+
+// Checks if the given file is a binary model.
+bool is_m1_binary_file(const std::string& file_name) {
+    std::ifstream file(file_name, std::ios::binary);
+    char magic[sizeof(BINARY_MODEL_MAGIC)] = {};
+    file.read(magic, sizeof(magic));
+    return file.gcount() == sizeof(magic) && std::memcmp(magic, BINARY_MODEL_MAGIC, sizeof(magic)) == 0;
+}
+
+
+// Serializes the model into the binary form, at the scale of the model. Returns the number of bytes written.
+size_t write_m1_binary_file(const std::string& file_name, const m1_data& data) {
+    std::filesystem::path file_path(file_name);
+    if (file_path.has_parent_path() && !exists(file_path.parent_path())) {
+        throw std::runtime_error("Directory does not exist: " + file_path.parent_path().string());
+    }
+    std::ofstream out_file(file_name, std::ios::binary | std::ios::trunc);
+    if (!out_file) {
+        throw std::runtime_error("Could not open file '" + file_name + "' for writing.");
+    }
+    if (data.meta.name.empty()) {std::cerr << "\tWarning: The given model must provide a name." << std::endl;}
+
+    // Every distinct string is stored once.
+    std::vector<const std::string*> strings;
+    std::map<std::string, std::uint32_t> string_ids;
+    auto intern = [&](const std::string& value) {
+        const auto [it, inserted] = string_ids.try_emplace(value, static_cast<std::uint32_t>(strings.size()));
+        if (inserted) {strings.push_back(&it->first);}
+        return it->second;
+    };
+    intern(data.meta.name);
+    std::vector<std::pair<std::uint32_t, std::uint32_t> > meta;
+    for (const auto& [key, value]: data.meta.values) {meta.emplace_back(intern(key), intern(value));}
+
+    // The records are zeroed before their fields are copied, so their padding is written as zeros.
+    std::vector<Binary_Node> nodes(data.nodes.size());
+    std::memset(static_cast<void*>(nodes.data()), 0, nodes.size() * sizeof(Binary_Node));
+    for (size_t i = 0; i < data.nodes.size(); ++i) {
+        nodes[i].startID = scaled_id(data.nodes[i].startID, data.scale);
+        nodes[i].endID = scaled_id(data.nodes[i].endID, data.scale);
+        nodes[i].node_type = intern(data.nodes[i].node_type);
+    }
+
+    std::vector<Binary_Edge_Type> edge_types(data.edges.size());
+    for (size_t i = 0; i < data.edges.size(); ++i) {
+        edge_types[i].edge_type = intern(data.edges[i].edge_type);
+        edge_types[i].n_blocks = data.edges[i].blocks.size();
+    }
+
+    // Lay out the file.
+    size_t position = sizeof(Binary_Model_Header);
+    for (const std::string* value: strings) {position += sizeof(std::uint32_t) + value->size();}
+    position += meta.size() * sizeof(meta[0]) + nodes.size() * sizeof(Binary_Node) + edge_types.size() * sizeof(Binary_Edge_Type);
+    for (auto& edge_type: edge_types) {
+        position = (position + BINARY_BLOCK_ALIGNMENT - 1) / BINARY_BLOCK_ALIGNMENT * BINARY_BLOCK_ALIGNMENT;
+        edge_type.offset = position;
+        position += edge_type.n_blocks * sizeof(Edge_Block);
+    }
+
+    Binary_Model_Header header = {};
+    std::memcpy(header.magic, BINARY_MODEL_MAGIC, sizeof(BINARY_MODEL_MAGIC));
+    header.version = BINARY_MODEL_VERSION;
+    header.byte_order = BINARY_BYTE_ORDER_MARK;
+    header.block_size = sizeof(Edge_Block);
+    header.id_fraction_bits = ContinuousNodeID::FRACTION_BITS;
+    header.file_size = position;
+    header.n_strings = strings.size();
+    header.n_meta = meta.size();
+    header.n_nodes = nodes.size();
+    header.n_edge_types = edge_types.size();
+
+    out_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const std::string* value: strings) {
+        const auto length = static_cast<std::uint32_t>(value->size());
+        out_file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out_file.write(value->data(), static_cast<std::streamsize>(value->size()));
+    }
+    out_file.write(reinterpret_cast<const char*>(meta.data()), static_cast<std::streamsize>(meta.size() * sizeof(meta[0])));
+    out_file.write(reinterpret_cast<const char*>(nodes.data()), static_cast<std::streamsize>(nodes.size() * sizeof(Binary_Node)));
+    out_file.write(reinterpret_cast<const char*>(edge_types.data()),
+        static_cast<std::streamsize>(edge_types.size() * sizeof(Binary_Edge_Type)));
+
+    // Blocks are copied field by field into a zeroed buffer, which leaves their padding zero.
+    std::vector<Edge_Block> chunk(BINARY_BLOCK_CHUNK);
+    std::memset(static_cast<void*>(chunk.data()), 0, chunk.size() * sizeof(Edge_Block));
+    const char padding[BINARY_BLOCK_ALIGNMENT] = {};
+    for (size_t i = 0; i < data.edges.size(); ++i) {
+        out_file.write(padding, static_cast<std::streamsize>(edge_types[i].offset - static_cast<size_t>(out_file.tellp())));
+        const Block_Array& blocks = data.edges[i].blocks;
+        for (size_t start = 0; start < blocks.size(); start += BINARY_BLOCK_CHUNK) {
+            const size_t n = std::min(BINARY_BLOCK_CHUNK, blocks.size() - start);
+            for (size_t j = 0; j < n; ++j) {
+                const Edge_Block block = scaled_block(blocks[start + j], data.scale);
+                chunk[j].startX = block.startX;
+                chunk[j].endX = block.endX;
+                chunk[j].startY = block.startY;
+                chunk[j].endY = block.endY;
+                chunk[j].expression_probability = block.expression_probability;
+            }
+            out_file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(n * sizeof(Edge_Block)));
+        }
+    }
+
+    if (!out_file.good()) {throw std::runtime_error("Could not write file '" + file_name + "'.");}
+    return static_cast<size_t>(out_file.tellp());
+}
+
+
+// Loads a binary model. The file stays mapped as long as the blocks of the model are in use.
+m1_data read_m1_binary_file(const std::string& file_name) {
+    auto file = std::make_shared<const Mapped_File>(file_name);
+    const char* const begin = file->data();
+    const size_t size = file->size();
+    size_t position = 0;
+
+    // Copies the next value from the file. Fails on truncated files.
+    auto take = [&](void* target, const size_t n) {
+        if (n > size - position) {throw std::runtime_error("'" + file_name + "' is truncated or not a valid binary model.");}
+        std::memcpy(target, begin + position, n);
+        position += n;
+    };
+    // Counts are checked against the remaining bytes before anything is allocated for them. Fails on corrupt counts.
+    auto check_count = [&](const std::uint64_t count, const size_t bytes_per_element) {
+        if (count > (size - position) / bytes_per_element) {
+            throw std::runtime_error("'" + file_name + "' is truncated or not a valid binary model.");
+        }
+    };
+
+    Binary_Model_Header header = {};
+    take(&header, sizeof(header));
+    if (std::memcmp(header.magic, BINARY_MODEL_MAGIC, sizeof(BINARY_MODEL_MAGIC)) != 0) {
+        throw std::runtime_error("'" + file_name + "' is not a binary model.");
+    }
+    if (header.version != BINARY_MODEL_VERSION) {
+        throw std::runtime_error("'" + file_name + "' uses version " + std::to_string(header.version)
+            + " of the binary model-format, which is not supported by this version of the generator.");
+    }
+    if (header.byte_order != BINARY_BYTE_ORDER_MARK || header.block_size != sizeof(Edge_Block)
+        || header.id_fraction_bits != ContinuousNodeID::FRACTION_BITS) {
+        throw std::runtime_error("'" + file_name + "' was written on a platform with a different representation of "
+            "the model. Save the model in the text-format there to use it on this platform.");
+    }
+    if (header.file_size != size) {
+        throw std::runtime_error("'" + file_name + "' is truncated or not a valid binary model.");
+    }
+
+    check_count(header.n_strings, sizeof(std::uint32_t));
+    std::vector<std::string> strings(header.n_strings);
+    for (auto& value: strings) {
+        std::uint32_t length = 0;
+        take(&length, sizeof(length));
+        check_count(length, 1);
+        value.resize(length);
+        take(value.data(), length);
+    }
+    auto string_at = [&](const std::uint32_t idx) -> const std::string& {
+        if (idx >= strings.size()) {throw std::runtime_error("'" + file_name + "' is not a valid binary model.");}
+        return strings[idx];
+    };
+
+    m1_data result = {};
+    if (strings.empty()) {throw std::runtime_error("'" + file_name + "' is not a valid binary model.");}
+    result.meta.name = strings[0];
+    check_count(header.n_meta, sizeof(std::pair<std::uint32_t, std::uint32_t>));
+    for (size_t i = 0; i < header.n_meta; ++i) {
+        std::pair<std::uint32_t, std::uint32_t> entry;
+        take(&entry, sizeof(entry));
+        result.meta.values[string_at(entry.first)] = string_at(entry.second);
+    }
+
+    check_count(header.n_nodes, sizeof(Binary_Node));
+    result.nodes.reserve(header.n_nodes);
+    for (size_t i = 0; i < header.n_nodes; ++i) {
+        Binary_Node node;
+        take(&node, sizeof(node));
+        result.nodes.emplace_back(Node_Record{node.startID, node.endID, string_at(node.node_type)});
+    }
+
+    check_count(header.n_edge_types, sizeof(Binary_Edge_Type));
+    result.edges.reserve(header.n_edge_types);
+    for (size_t i = 0; i < header.n_edge_types; ++i) {
+        Binary_Edge_Type edge_type;
+        take(&edge_type, sizeof(edge_type));
+        if (edge_type.offset > size || edge_type.n_blocks > (size - edge_type.offset) / sizeof(Edge_Block)) {
+            throw std::runtime_error("'" + file_name + "' is truncated or not a valid binary model.");
+        }
+        const char* blocks = begin + edge_type.offset;
+        Edge_Record record = {};
+        record.edge_type = string_at(edge_type.edge_type);
+        if (reinterpret_cast<std::uintptr_t>(blocks) % alignof(Edge_Block) == 0) {
+            record.blocks = Block_Array(file, reinterpret_cast<const Edge_Block*>(blocks), edge_type.n_blocks);
+        } else {
+            // Only if the file could not be mapped and was read into a misaligned buffer.
+            std::vector<Edge_Block> copied(edge_type.n_blocks);
+            std::memcpy(copied.data(), blocks, edge_type.n_blocks * sizeof(Edge_Block));
+            record.blocks = Block_Array(std::move(copied));
+        }
+        result.edges.push_back(std::move(record));
+    }
+
+    if (result.nodes.empty()) {throw std::runtime_error("'" + file_name + "' is missing a valid NODES-Section with at least one node type.");}
+    if (result.edges.empty()) {throw std::runtime_error("'" + file_name + "' is missing a valid EDGES-Section with at least an edge type.");}
+
+    std::cout << "\tRead " << result.nodes.size() << " type(s) of nodes and " << result.edges.size() << " type(s) of edges." << std::endl;
+    return result;
+}
+
+
+// Loads a model in either form.
+m1_data load_m1_model(const std::string& file_name) {
+    if (is_m1_binary_file(file_name)) {return read_m1_binary_file(file_name);}
+    return read_m1_file(file_name);
+}
+
+// Saves a model, in the binary form if the name of the file ends in '.m1b'. Returns the number of bytes written.
+size_t save_m1_model(const std::string& file_name, const m1_data& data) {
+    if (std::filesystem::path(file_name).extension() == ".m1b") {return write_m1_binary_file(file_name, data);}
+    return write_m1_file(file_name, data);
+}
@@ -1,13 +1,18 @@
 #include "../src/graphgenerator_types.h"
+#include "../src/graphgenerator_format.h"
+#include "../src/graphgenerator_mmap.h"
+#include "../src/graphgenerator_compressed.h"
+#include "../src/graphgenerator_parallel.h"
+#include <charconv>
+#include <cstring>
 #include <vector>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <map>
+#include <memory>
 #include <filesystem>
 
-constexpr uint8_t RESERVED_BYTES_FOR_STRING_CONSTRUCTION = 128;
-
 struct Meta_Record {
     std::string name;
     std::map<std::string, std::string> values;
@@ -37,311 +42,594 @@ struct Edge_Block {
     }
 };
 
+// The blocks of an edge-type. They are either owned, or used in place from a memory-mapped binary model, which is
+//  kept open as long as any array refers to it. Modifying the blocks of a mapped model copies them first.
+class Block_Array {
+public:
+    Block_Array() = default;
+    Block_Array(std::vector<Edge_Block> blocks_): owned(std::move(blocks_)) {}
+    Block_Array(std::shared_ptr<const Mapped_File> file_, const Edge_Block* blocks_, const size_t count_):
+        file(std::move(file_)), mapped(blocks_), count(count_) {}
+
+    [[nodiscard]] const Edge_Block* begin() const {return this->file ? this->mapped : this->owned.data();}
+    [[nodiscard]] const Edge_Block* end() const {return this->begin() + this->size();}
+    [[nodiscard]] size_t size() const {return this->file ? this->count : this->owned.size();}
+    [[nodiscard]] bool empty() const {return this->size() == 0;}
+    [[nodiscard]] const Edge_Block& operator[](const size_t idx) const {return this->begin()[idx];}
+
+    void reserve(const size_t n) {this->materialize().reserve(n);}
+    template <typename... Args>
+    void emplace_back(Args&&... args) {this->materialize().emplace_back(std::forward<Args>(args)...);}
+    template <typename Iterator>
+    void insert(const Edge_Block* position, Iterator first, Iterator last) {
+        const size_t offset = position - this->begin();
+        auto& blocks = this->materialize();
+        blocks.insert(blocks.begin() + static_cast<long>(offset), first, last);
+    }
+
+private:
+    std::vector<Edge_Block>& materialize() {
+        if (this->file) {
+            this->owned.assign(this->mapped, this->mapped + this->count);
+            this->file.reset();
+        }
+        return this->owned;
+    }
+
+    std::vector<Edge_Block> owned;
+    std::shared_ptr<const Mapped_File> file;
+    const Edge_Block* mapped = nullptr;
+    size_t count = 0;
+};
+
 struct Edge_Record {
     std::string edge_type;
-    std::vector<Edge_Block> blocks;
+    Block_Array blocks;
     bool operator< (const Edge_Record& rhs) const {
         return (this->edge_type < rhs.edge_type);
     }
 };
 
+// The nodes and blocks are kept as they were read. Scaling the model only multiplies its scale, which is applied to
+//  the IDs and probabilities whenever the model is generated from or saved, see scale_m1_data.
 struct m1_data {
     Meta_Record meta;
     std::vector<Node_Record> nodes;
     std::vector<Edge_Record> edges;
+    long double scale = 1;
 };
 
-enum ReaderMode {
-    NONE,
-    META,
-    NODES,
-    EDGES,
+// An ID of the model at the given scale, as it is saved. The product is rounded to the nearest fixed-point ID with
+//  the same integer part.
+inline ContinuousNodeID scaled_id(const ContinuousNodeID id, const long double scale) {
+    return scale == 1 ? id : ContinuousNodeID::from_real(id.to_real() * scale);
+}
+
+// The integer part of an ID at the given scale, from which the NodeIDs of a range are recovered. It is taken from the
+//  product in extended precision, exactly as if the model had held its IDs as long doubles.
+inline NodeID scaled_integer_part(const ContinuousNodeID id, const long double scale) {
+    return scale == 1 ? id.integer_part() : ContinuousNodeID::integer_part_of(id.to_real() * scale);
+}
+
+// A block of the model at the given scale, as it is saved. As the number of nodes is increased, the
+//  expression-probability is reduced by the same factor, which retains the expected In-/Out-Degrees of the nodes.
+//  Probabilities are clamped to a maximum of 1.0, which should only be necessary when scaling down.
+inline Edge_Block scaled_block(const Edge_Block& block, const long double scale) {
+    if (scale == 1) {return block;}
+    Probability probability = static_cast<Probability>(block.expression_probability / scale);
+    if (probability > 1) {probability = 1;}
+    return Edge_Block(scaled_id(block.startX, scale), scaled_id(block.endX, scale), scaled_id(block.startY, scale),
+        scaled_id(block.endY, scale), probability);
+}
+
+// EDGES-sections larger than twice this are parsed in several parts.
+constexpr size_t MIN_BYTES_PER_M1_PART = 1 << 22;
+
+// Parses IDs written as plain decimals, which covers all IDs written by the generator. The value is rounded to the
+//  nearest fixed-point value with the same integer part exactly: The midpoints between two fixed-point values have
+//  FRACTION_BITS + 1 decimals, so only as many decimals decide the result. These are evaluated in parts of 12, 12
+//  and 1 digits to stay within 64 bits.
+inline bool parse_m1_decimal_id(const std::string_view field, ContinuousNodeID& value) {
+    static_assert(ContinuousNodeID::FRACTION_BITS <= 24);
+    constexpr std::uint64_t PART_DIGITS = 1000000000000ULL;   // 10^12
+    size_t idx = 0;
+    std::uint64_t integer = 0;
+    while (idx < field.size() && idx < 19 && field[idx] >= '0' && field[idx] <= '9') {
+        integer = integer * 10 + (field[idx++] - '0');
+    }
+    if (idx == 0 || integer > ContinuousNodeID::MAX_INTEGER) {return false;}
+    if (idx == field.size()) {
+        value = ContinuousNodeID(integer);
+        return true;
+    }
+    std::uint64_t high = 0, low = 0, last = 0;
+    size_t digit = 0;
+    if (field[idx++] != '.') {return false;}
+    for (; idx < field.size(); ++idx, ++digit) {
+        if (field[idx] < '0' || field[idx] > '9') {return false;}
+        if (digit < 12) {high = high * 10 + (field[idx] - '0');}
+        else if (digit < 24) {low = low * 10 + (field[idx] - '0');}
+        else if (digit == 24) {last = field[idx] - '0';}
+    }
+    for (; digit < 24; ++digit) {
+        if (digit < 12) {high *= 10;} else {low *= 10;}
+    }
+    // floor((high * 10^13 + low * 10 + last) * 2^FRACTION_BITS / 10^25 + 1/2), the remainders are carried down.
+    const std::uint64_t scaled_high = high << ContinuousNodeID::FRACTION_BITS;
+    const std::uint64_t scaled_low = low << ContinuousNodeID::FRACTION_BITS;
+    const std::uint64_t remainder = (scaled_low % PART_DIGITS) * 10 + (last << ContinuousNodeID::FRACTION_BITS);
+    std::uint64_t fraction = scaled_high / PART_DIGITS + (scaled_high % PART_DIGITS + scaled_low / PART_DIGITS
+        + PART_DIGITS / 2 + remainder / (PART_DIGITS * 10)) / PART_DIGITS;
+    if (fraction >= ContinuousNodeID::ONE) {fraction = ContinuousNodeID::ONE - 1;}
+    value = ContinuousNodeID::from_raw((integer << ContinuousNodeID::FRACTION_BITS) + fraction);
+    return true;
+}
+
+// Parses a number of an m1-file. Surrounding spaces are ignored, anything else in the field is invalid. IDs in
+//  another notation (e.g. with an exponent) are parsed as long doubles and rounded as any real value. IDs out of the range of
+//  ContinuousNodeID are invalid.
+template <typename T>
+bool parse_m1_number(std::string_view field, T& value) {
+    while (!field.empty() && (field.front() == ' ' || field.front() == '\t')) {field.remove_prefix(1);}
+    while (!field.empty() && (field.back() == ' ' || field.back() == '\t')) {field.remove_suffix(1);}
+    if (field.empty()) {return false;}
+    if constexpr (std::is_same_v<T, ContinuousNodeID>) {
+        if (parse_m1_decimal_id(field, value)) {return true;}
+        long double real = 0;
+        const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), real);
+        if (error != std::errc() || end != field.data() + field.size()) {return false;}
+        if (!(real >= 0) || real >= static_cast<long double>(ContinuousNodeID::MAX_INTEGER) + 1) {return false;}
+        value = ContinuousNodeID::from_real(real);
+        return true;
+    } else {
+        const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+        return error == std::errc() && end == field.data() + field.size();
+    }
+}
+
+// Splits the next field up to the separator off the front of the line. The last field takes the rest of the line.
+inline std::string_view next_m1_field(std::string_view& line, const char separator) {
+    const size_t idx = line.find(separator);
+    const std::string_view field = line.substr(0, idx);
+    line.remove_prefix(idx == std::string_view::npos ? line.size() : idx + 1);
+    return field;
+}
+
+// Calls line(l) for every non-empty line. Stray \r characters are removed. These may appear in files created under
+//  windows (\r\n instead of just \n).
+template <typename Function>
+void for_each_m1_line(std::string_view lines, const Function& line) {
+    while (!lines.empty()) {
+        std::string_view l = next_m1_field(lines, '\n');
+        if (l.ends_with('\r')) {l.remove_suffix(1);}
+        if (!l.empty()) {line(l);}
+    }
+}
+
+// A section of an m1-file: The line declaring it ('#...') and all lines up to the next declaration.
+struct M1_Section {
+    std::string_view directive;
+    std::string_view body;
 };
 
-// De-Serializes a given file of m1-format into a struct of m1_data.
-// Some recoverable deviations from the definition of the m1-format are tolerated, but warned about.
-m1_data read_m1_file(const std::string& file_name) {
-    m1_data result = {};
+// Splits the content of an m1-file at every line starting with '#'. The lines before the first declaration form the
+//  first section, which has no directive.
+std::vector<M1_Section> find_m1_sections(const std::string_view content) {
+    std::vector<M1_Section> sections;
+    size_t position = content.starts_with('#') ? 0 : content.find("\n#");
+    if (position != std::string_view::npos && content[position] == '\n') {++position;}
+    sections.push_back({{}, content.substr(0, position)});
+
+    while (position < content.size()) {
+        const size_t line_end = content.find('\n', position);
+        std::string_view directive = content.substr(position, line_end - position);
+        if (directive.ends_with('\r')) {directive.remove_suffix(1);}
+        const size_t body_start = line_end == std::string_view::npos ? content.size() : line_end + 1;
+        const size_t next = line_end == std::string_view::npos ? line_end : content.find("\n#", line_end);
+        const size_t body_end = next == std::string_view::npos ? content.size() : next + 1;
+        sections.push_back({directive, content.substr(body_start, body_end - body_start)});
+        position = body_end;
+    }
+    return sections;
+}
 
-    std::ifstream file(file_name.data());
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file " + file_name + ".");
+// Parses a line of an EDGES-section into a block. Malformed lines are skipped and warned about.
+void parse_m1_edge_line(const std::string_view line, const std::string& file_name, std::vector<Edge_Block>& blocks,
+    std::ostream& warnings) {
+    std::string_view fields = line;
+    const std::string_view startX = next_m1_field(fields, ',');
+    const std::string_view endX = next_m1_field(fields, ',');
+    const std::string_view startY = next_m1_field(fields, ',');
+    const std::string_view endY = next_m1_field(fields, ',');
+    const std::string_view probability = fields;
+    // Check for incomplete data in the line.
+    if (startX.empty() || endX.empty() || startY.empty() || endY.empty() || probability.empty()) {
+        warnings << "\tEncountered incomplete line (" << line << ") in mode EDGES while parsing m1-file ("
+                            << file_name << "). Skipping.\n";
+        return;
+    }
+    // If the line is complete, try to parse it.
+    ContinuousNodeID startXID;
+    ContinuousNodeID endXID;
+    ContinuousNodeID startYID;
+    ContinuousNodeID endYID;
+    Probability f_probability;
+    if (!parse_m1_number(startX, startXID) || !parse_m1_number(endX, endXID)
+        || !parse_m1_number(startY, startYID) || !parse_m1_number(endY, endYID)) {
+        warnings << "\tCould not parse one or more elements into a valid number in line ("
+                    << line << ") in mode EDGES while parsing m1-file (" << file_name << "). Skipping.\n";
+        return;
+    }
+    if (!parse_m1_number(probability, f_probability)) {
+        warnings << "\tCould not parse '" << probability << "' into a valid float in line ("
+                    << line << ") in mode EDGES while parsing m1-file (" << file_name << "). Skipping.\n";
+        return;
     }
 
-    bool has_meta = false, has_node = false, has_edges = false;
-    std::string current_edge_type;
-    std::vector<Edge_Block> current_blocks;
-    ReaderMode mode = NONE;
-    std::string line;
-    while (std::getline(file, line)) {
-        // Remove stray \r characters. These may appear in files created under windows (\r\n instead of just \n)
-        if (line.ends_with('\r')) {
-            line.erase(line.length() - 1, 1);
-        }
-        // Empty lines are disregarded.
-        if (line.empty()) {continue;}
-
-        // Lines starting with '#' indicate the declaration of a new block. Change mode accordingly.
-        if (line.starts_with('#')) {
-            if (line.starts_with("# META")) {mode = META;}
-            else if (line.starts_with("# NODES")) {mode = NODES;}
-            else if (line.starts_with("# EDGES")) {
-                // A block of type EDGES requires further initialization.
-                mode = EDGES;
-                // If any edge-blocks have been read within the current edge type, save them to the data structure.
-                if (!current_blocks.empty()) {
-                    result.edges.push_back(Edge_Record(current_edge_type, current_blocks));
-                    has_edges = true;
+    // Finally create a new block for valid lines.
+    blocks.emplace_back(Edge_Block(startXID, endXID, startYID, endYID, f_probability));
+}
+
+// Parses a line of the META-section. Returns true if the line declared the name of the model.
+bool parse_m1_meta_line(const std::string_view line, const std::string& file_name, Meta_Record& meta) {
+    std::string_view fields = line;
+    const std::string_view key = next_m1_field(fields, '=');
+    const std::string_view value = fields;
+    // Check for incomplete data in the line.
+    if (key.empty() || value.empty()) {
+        std::cerr << "\tEncountered incomplete line (" << line << ") in mode META while parsing m1-file ("
+                            << file_name << "). Skipping." << std::endl;
+        return false;
+    }
+    // We explicitly define a name in the description of the m1-standard. This is accounted for in a designated
+    //      variable, other keys are thrown into a map to be used at the informed users' discretion.
+    if (key == "NAME") {
+        meta.name = value;
+        return true;
+    }
+    meta.values[std::string(key)] = value;
+    return false;
+}
+
+// Parses a line of the NODES-section. Returns true if a node-record was added.
+bool parse_m1_node_line(const std::string_view line, const std::string& file_name, std::vector<Node_Record>& nodes) {
+    std::string_view fields = line;
+    const std::string_view start = next_m1_field(fields, ',');
+    const std::string_view end = next_m1_field(fields, ',');
+    const std::string_view node_type = fields;
+    // Check for incomplete data in the line.
+    if (start.empty() || end.empty() || node_type.empty()) {
+        std::cerr << "\tEncountered incomplete line (" << line << ") in mode NODES while parsing m1-file ("
+                            << file_name << "). Skipping." << std::endl;
+        return false;
+    }
+    // If the line is complete, try to parse it.
+    ContinuousNodeID startID = 0;
+    ContinuousNodeID endID = 0;
+    if (!parse_m1_number(start, startID) || !parse_m1_number(end, endID)) {
+        std::cerr << "\tCould not parse '" << start << "' or '" << end << "' into a valid number in line ("
+                    << line << ") in mode NODES while parsing m1-file (" << file_name << "). Skipping."
+                    << std::endl;
+        return false;
+    }
+
+    // Finally create a new node-record for valid lines.
+    nodes.emplace_back(Node_Record{startID, endID, std::string(node_type)});
+    return true;
+}
+
+// Parses the content of an m1-file, which is handed over in one or several blocks of complete lines. Each block
+//  continues the section in which the previous block ended. Some recoverable deviations from the definition of the
+//  m1-format are tolerated, but warned about.
+// Every block is split into its sections in a single scan. The EDGES-sections are independent of each other and
+//  parsed concurrently, large sections in several parts. Numbers are parsed in place.
+class M1_Parser {
+public:
+    explicit M1_Parser(const std::string& file_name_): file_name(file_name_) {}
+
+    void parse(const std::string_view content) {
+        const std::vector<M1_Section> sections = find_m1_sections(content);
+
+        // Split the EDGES-sections into parts of complete lines and parse all parts concurrently. The first section
+        //  continues the EDGES-section of the previous block, if any.
+        struct Edge_Part {
+            size_t section;
+            std::string_view lines;
+            std::vector<Edge_Block> blocks;
+            std::ostringstream warnings;
+        };
+        std::vector<Edge_Part> parts;
+        for (size_t idx = 0; idx < sections.size(); ++idx) {
+            const bool is_edges = idx == 0 ? this->mode == Mode::Edges : sections[idx].directive.starts_with("# EDGES");
+            if (!is_edges) {continue;}
+            std::string_view body = sections[idx].body;
+            while (!body.empty()) {
+                size_t end = body.size();
+                if (body.size() > 2 * MIN_BYTES_PER_M1_PART) {
+                    end = body.find('\n', MIN_BYTES_PER_M1_PART);
+                    end = end == std::string_view::npos ? body.size() : end + 1;
                 }
-                size_t idx = line.find('=');
-                // Reset the content of the current vector of edge-blocks.
-                current_edge_type = line.substr(idx + 1);
-                current_blocks = std::vector<Edge_Block>();
-            }
-            else {
-                std::string message;
-                            message.append("Encountered unexpected directive '");
-                            message.append(line);
-                            message.append("' while parsing m1-file (");
-                            message.append(file_name);
-                            message.append("). The file may be malformed.");
-                throw std::runtime_error(message);
+                parts.push_back({idx, body.substr(0, end), {}, {}});
+                body.remove_prefix(end);
             }
-            continue;
         }
-
-        switch (mode) {
-            case NONE: {
-                std::string message;
-                message.append("Encountered unexpected line '");
-                message.append(line);
-                message.append("' in mode NONE while parsing m1-file (");
-                message.append(file_name);
-                message.append(").");
-                throw std::runtime_error(message);
+        run_tasks_in_parallel(parts.size(), [&](const size_t part_idx) {
+            Edge_Part& part = parts[part_idx];
+            for_each_m1_line(part.lines, [&](const std::string_view line) {
+                parse_m1_edge_line(line, this->file_name, part.blocks, part.warnings);
+            });
+        });
+
+        // All other sections are handled in the order of the file.
+        size_t next_part = 0;
+        for (size_t idx = 0; idx < sections.size(); ++idx) {
+            const auto& [directive, body] = sections[idx];
+
+            if (idx > 0) {
+                this->finish_edges();
+                if (directive.starts_with("# META")) {
+                    this->mode = Mode::Meta;
+                } else if (directive.starts_with("# NODES")) {
+                    this->mode = Mode::Nodes;
+                } else if (directive.starts_with("# EDGES")) {
+                    this->mode = Mode::Edges;
+                    this->edge_type = directive.substr(directive.find('=') + 1);
+                } else {
+                    throw std::runtime_error("Encountered unexpected directive '" + std::string(directive)
+                        + "' while parsing m1-file (" + this->file_name + "). The file may be malformed.");
+                }
             }
 
-            case META: {
-                std::stringstream ss_meta(line);
-                std::string key;
-                std::string value;
-                std::getline(ss_meta, key, '=');
-                std::getline(ss_meta, value);
-                // Check for incomplete data in the line.
-                if (key.empty() || value.empty()) {
-                    std::cerr << "\tEncountered incomplete line (" << line << ") in mode META while parsing m1-file ("
-                                        << file_name << "). Skipping." << std::endl;
-                    break;
+            if (this->mode == Mode::None) {
+                for_each_m1_line(body, [&](const std::string_view line) {
+                    throw std::runtime_error("Encountered unexpected line '" + std::string(line)
+                        + "' in mode NONE while parsing m1-file (" + this->file_name + ").");
+                });
+
+            } else if (this->mode == Mode::Meta) {
+                for_each_m1_line(body, [&](const std::string_view line) {
+                    this->has_meta |= parse_m1_meta_line(line, this->file_name, this->result.meta);
+                });
+
+            } else if (this->mode == Mode::Nodes) {
+                for_each_m1_line(body, [&](const std::string_view line) {
+                    this->has_node |= parse_m1_node_line(line, this->file_name, this->result.nodes);
+                });
+
+            } else {
+                // Join the parts of the section.
+                for (; next_part < parts.size() && parts[next_part].section == idx; ++next_part) {
+                    std::cerr << parts[next_part].warnings.str();
+                    if (this->edge_blocks.empty()) {
+                        this->edge_blocks = std::move(parts[next_part].blocks);
+                    } else {
+                        this->edge_blocks.insert(this->edge_blocks.end(), parts[next_part].blocks.begin(), parts[next_part].blocks.end());
+                    }
+                    std::vector<Edge_Block>().swap(parts[next_part].blocks);
                 }
-                // We explicitly define a name in the description of the m1-standard. This is accounted for in a designated
-                //      variable, other keys are thrown into a map to be used at the informed users' discretion.
-                if (key == "NAME") {
-                    result.meta.name = value;
-                    has_meta = true;
-                }  else {
-                    result.meta.values[key] = value;
-                }
-                break;
             }
+        }
+    }
 
-            case NODES: {
-                std::stringstream ss_nodes(line);
-                std::string start;
-                std::string start_dec;
-                std::string end;
-                std::string end_dec;
-                std::string node_type;
-                std::getline(ss_nodes, start, ',');
-                std::getline(ss_nodes, end, ',');
-                std::getline(ss_nodes, node_type);
-                // Check for incomplete data in the line.
-                if (start.empty() || end.empty() || node_type.empty()) {
-                    std::cerr << "\tEncountered incomplete line (" << line << ") in mode NODES while parsing m1-file ("
-                                        << file_name << "). Skipping." << std::endl;
-                    break;
-                }
-                // If the line is complete, try to parse it.
-                ContinuousNodeID startID = 0;
-                ContinuousNodeID endID = 0;
-                try {
-                    startID = std::stold(start);
-                    endID = std::stold(end);
-                } catch (std::exception& e) {
-                    std::cerr << "\tCould not parse '" << start << "' or '" << end << "' into a valid uLL in line ("
-                                << line << ") in mode NODES while parsing m1-file (" << file_name << "). Skipping."
-                                << std::endl;
-                    std::cerr << e.what() << std::endl;
-                    break;
-                }
+    // Ends the file and returns the model.
+    m1_data finish() {
+        this->finish_edges();
+        if (!this->has_meta) {throw std::runtime_error("'" + this->file_name + "' is missing a valid META-Section with at least a 'NAME=...' declaration.");}
+        if (!this->has_node) {throw std::runtime_error("'" + this->file_name + "' is missing a valid NODES-Section with at least one node type.");}
+        if (!this->has_edges) {throw std::runtime_error("'" + this->file_name + "' is missing a valid EDGES-Section with at least an edge type.");}
+        return std::move(this->result);
+    }
 
-                // Finally create a new node-record for valid lines.
-                result.nodes.emplace_back(Node_Record{startID, endID, node_type});
-                has_node = true;
-                break;
-            }
+private:
+    enum class Mode {None, Meta, Nodes, Edges};
 
-            case EDGES: {
-                std::stringstream ss_edges(line);
-                std::string startX;
-                std::string endX;
-                std::string startY;
-                std::string endY;
-                std::string probability;
-                std::getline(ss_edges, startX, ',');
-                std::getline(ss_edges, endX, ',');
-                std::getline(ss_edges, startY, ',');
-                std::getline(ss_edges, endY, ',');
-                std::getline(ss_edges, probability);
-                // Check for incomplete data in the line.
-                if (startX.empty() || endX.empty() || startY.empty() || endY.empty() || probability.empty()) {
-                    std::cerr << "\tEncountered incomplete line (" << line << ") in mode EDGES while parsing m1-file ("
-                                        << file_name << "). Skipping." << std::endl;
-                    break;
-                }
-                // If the line is complete, try to parse it.
-                ContinuousNodeID startXID;
-                ContinuousNodeID endXID;
-                ContinuousNodeID startYID;
-                ContinuousNodeID endYID;
-                Probability f_probability;
-                try {
-                    startXID = std::stold(startX);
-                    endXID = std::stold(endX);
-                    startYID = std::stold(startY);
-                    endYID = std::stold(endY);
-                } catch (std::exception& e) {
-                    std::cerr << "\tCould not parse one or more elements into a valid uLL in line ("
-                                << line << ") in mode NODES while parsing m1-file (" << file_name << "). Skipping."
-                                << std::endl;
-                    std::cerr << e.what() << std::endl;
-                    break;
-                }
+    // Ends the current EDGES-section. Sections without any valid blocks are dropped.
+    void finish_edges() {
+        if (this->mode != Mode::Edges || this->edge_blocks.empty()) {return;}
+        this->result.edges.push_back(Edge_Record(std::move(this->edge_type), std::move(this->edge_blocks)));
+        this->edge_blocks = {};
+        this->has_edges = true;
+    }
 
-                try {
-                    f_probability = std::stof(probability);
-                } catch (std::exception& e) {
-                    std::cerr << "\tCould not parse '" << probability << "' into a valid float in line ("
-                                << line << ") in mode NODES while parsing m1-file (" << file_name << "). Skipping."
-                                << std::endl;
-                    std::cerr << e.what() << std::endl;
-                    break;
-                }
+    std::string file_name;
+    m1_data result = {};
+    Mode mode = Mode::None;
+    std::string edge_type;
+    std::vector<Edge_Block> edge_blocks;
+    bool has_meta = false, has_node = false, has_edges = false;
+};
 
-                // Finally create a new block for valid lines.
-                // Full records for this edge-type are only added once another edge-type is detected or parsing ends.
-                current_blocks.emplace_back(Edge_Block(startXID, endXID, startYID, endYID, f_probability));
-                break;
+// De-Serializes a given file of m1-format into a struct of m1_data.
+// Plain files are mapped into memory and parsed at once. Compressed files (gzip, zstd or zip) are parsed block by
+//  block, while the next block is decompressed, so the uncompressed model is never held as a whole.
+m1_data read_m1_file(const std::string& file_name) {
+    if (!std::filesystem::is_regular_file(file_name)) {
+        throw std::runtime_error("Failed to open file " + file_name + ".");
+    }
+    Text_Input input(file_name);
+    M1_Parser parser(file_name);
+    std::string_view block;
+    while (input.next_block(block)) {
+        parser.parse(block);
+    }
+    m1_data result = parser.finish();
+
+    std::cout << "\tRead " << result.nodes.size() << " type(s) of nodes and " << result.edges.size() << " type(s) of edges"
+        << input.description() << "." << std::endl;
+    return result;
+}
+
+
+// Output-buffer for m1-files. Lines are formatted in place and written to the file in large chunks.
+//  The buffer has to be flushed after the last line, the destructor only releases it.
+class M1_Writer {
+public:
+    explicit M1_Writer(Compressing_Writer& file_): file(file_), buffer(WRITE_BUFFER_SIZE) {}
+
+    // Makes sure that the given number of bytes can be appended.
+    void reserve(const size_t n) {
+        if (this->position + n > this->buffer.size()) {
+            this->flush();
+            if (n > this->buffer.size()) {this->buffer.resize(n);}
+        }
+    }
+
+    void append(const std::string_view text) {
+        this->reserve(text.size());
+        std::memcpy(this->buffer.data() + this->position, text.data(), text.size());
+        this->position += text.size();
+    }
+
+    void append(const char c) {
+        this->reserve(1);
+        this->buffer[this->position++] = c;
+    }
+
+    // Numbers are written in the shortest form that parses back to the same value.
+    template <typename T>
+    void append_number(const T value, const std::chars_format format) {
+        this->reserve(MAX_NUMBER_LENGTH);
+        char* const begin = this->buffer.data() + this->position;
+        // Integers are written directly, which is considerably faster.
+        if (value >= 0 && value < static_cast<T>(MAX_DIRECT_INTEGER) && std::trunc(value) == value) {
+            this->position += unsafe_u64Int_to_str(begin, static_cast<std::uint64_t>(value));
+            return;
+        }
+        const auto [end, error] = std::to_chars(begin, begin + MAX_NUMBER_LENGTH, value, format);
+        if (error != std::errc()) {throw std::runtime_error("Could not format the value " + std::to_string(value) + ".");}
+        this->position += end - begin;
+    }
+
+    // IDs are written with the fewest decimals that parse back to the same fixed-point value, which are at most 8 for
+    //  24 fraction bits. The decimals are rounded up into the interval of values that are rounded to it, which ends
+    //  half-way to the next value, or at the next integer for the last value before it.
+    void append_id(const ContinuousNodeID value) {
+        this->reserve(MAX_NUMBER_LENGTH);
+        this->position += unsafe_u64Int_to_str(this->buffer.data() + this->position, value.integer_part());
+        const std::uint64_t fraction = value.fraction();
+        if (fraction == 0) {return;}
+        // Bounds of the interval in units of half a fixed-point step.
+        const std::uint64_t lower = 2 * fraction - 1;
+        const std::uint64_t upper = fraction == ContinuousNodeID::ONE - 1 ? 2 * ContinuousNodeID::ONE : 2 * fraction + 1;
+        std::uint64_t power = 1;
+        for (size_t digits = 1; ; ++digits) {
+            power *= 10;
+            std::uint64_t decimals = (lower * power + 2 * ContinuousNodeID::ONE - 1) >> (ContinuousNodeID::FRACTION_BITS + 1);
+            if (decimals * 2 * ContinuousNodeID::ONE < upper * power) {
+                this->buffer[this->position++] = '.';
+                for (size_t idx = digits; idx > 0; --idx) {
+                    this->buffer[this->position + idx - 1] = static_cast<char>('0' + decimals % 10);
+                    decimals /= 10;
+                }
+                this->position += digits;
+                return;
             }
         }
     }
 
-    // If any edge-blocks have been read within the current edge type, save them to the data structure.
-    if (!current_blocks.empty()) {
-        result.edges.push_back(Edge_Record(current_edge_type, current_blocks));
-        has_edges = true;
+    void flush() {
+        this->file.write(std::string_view(this->buffer.data(), this->position));
+        this->position = 0;
     }
 
-    if (!has_meta) {throw std::runtime_error("'" + file_name + "' is missing a valid META-Section with at least a 'NAME=...' declaration.");}
-    if (!has_node) {throw std::runtime_error("'" + file_name + "' is missing a valid NODES-Section with at least one node type.");}
-    if (!has_edges) {throw std::runtime_error("'" + file_name + "' is missing a valid EDGES-Section with at least an edge type.");}
+private:
+    static constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+    // Integer part of an ID, the point and its decimals, or a float in general notation.
+    static constexpr size_t MAX_NUMBER_LENGTH = 64;
+    static constexpr std::uint64_t MAX_DIRECT_INTEGER = 1ULL << 53;
 
-    std::cout << "\tRead " << result.nodes.size() << " type(s) of nodes and " << result.edges.size() << " type(s) of edges." << std::endl;
-    return result;
-}
+    Compressing_Writer& file;
+    std::vector<char> buffer;
+    size_t position = 0;
+};
 
-// Serializes a passed struct of m1_data to a conformant m1-model-file. Certain deviations from the definition of the m1-format
-//      are tolerated (i.e. not passing a model-name), but receive a warning on std::cerr.
-// Returns the (approximate) number of bytes written.
+// Serializes a passed struct of m1_data to a conformant m1-model-file, at the scale of the model. Certain deviations from the
+//      definition of the m1-format are tolerated (i.e. not passing a model-name), but receive a warning on std::cerr.
+// Numbers are written in their shortest form that reads back to the same value, a written model is read back unchanged.
+// Files ending in '.gz' or '.zst' are compressed while they are written.
+// Returns the number of bytes written.
 size_t write_m1_file(const std::string& file_name, const m1_data& data) {
     std::filesystem::path file_path(file_name);
     if (file_path.has_parent_path() && !exists(file_path.parent_path())) {
         throw std::runtime_error("Directory does not exist: " + file_path.parent_path().string());
     }
 
-    std::ofstream out_file(file_name);
-    if (!out_file) {
-        throw std::runtime_error("Directory does not exist: " + file_path.string());
-    }
-    size_t bytes_at_start = out_file.tellp();
-
-    // Write the provided meta-data.
-    if (data.meta.name.empty()) {std::cerr << "\tWarning: The given model must provide a name." << std::endl;}
-    out_file << "# META\n";
-    out_file << "NAME=" << data.meta.name << std::endl;
-    for (const auto& [key, value] : data.meta.values) {
-        if (key.find('=') != std::string::npos) {
-            throw std::runtime_error("Equal-Signs '=' are not allowed as part of the key given in {" + key + ": " + value + "}");
-        }
-        if (key.find('\n') != std::string::npos or value.find('\n') != std::string::npos) {
-            throw std::runtime_error("Newline-Characters are not allowed as part of the Key/Value-Pair given in : {" + key + ":" + value + "}");
-        }
-        out_file << key << "=" << value << std::endl;
-    }
-    out_file << std::endl;
-
-    // Write the provided node-data.
-    out_file << "# NODES\n";
-    std::string node_str;
-    node_str.reserve(RESERVED_BYTES_FOR_STRING_CONSTRUCTION);
-    // #pragma omp parallel for private(node_str)
-    for (const auto& [startID, endID, node_type]: data.nodes) {
-        if (node_type.find('\n') != std::string::npos) {
-            throw std::runtime_error("Newline-Characters are not allowed as part of the node-type given: " + node_type);
+    Compressing_Writer out_file(file_name, compression_for_extension(file_name));
+    {
+        M1_Writer writer(out_file);
+
+        // Write the provided meta-data.
+        if (data.meta.name.empty()) {std::cerr << "\tWarning: The given model must provide a name." << std::endl;}
+        writer.append("# META\n");
+        writer.append("NAME=");
+        writer.append(data.meta.name);
+        writer.append('\n');
+        for (const auto& [key, value] : data.meta.values) {
+            if (key.find('=') != std::string::npos) {
+                throw std::runtime_error("Equal-Signs '=' are not allowed as part of the key given in {" + key + ": " + value + "}");
+            }
+            if (key.find('\n') != std::string::npos or value.find('\n') != std::string::npos) {
+                throw std::runtime_error("Newline-Characters are not allowed as part of the Key/Value-Pair given in : {" + key + ":" + value + "}");
+            }
+            writer.append(key);
+            writer.append('=');
+            writer.append(value);
+            writer.append('\n');
         }
-        // Manual string-construction for performance / multithreading reasons.
-        node_str = "";
-        node_str.append(std::to_string(startID));
-        node_str.push_back(',');
-        node_str.append(std::to_string(endID));
-        node_str.push_back(',');
-        node_str.append(node_type);
-        node_str.push_back('\n');
-        out_file << node_str;
-    }
-    out_file << std::endl;
-
-    // Write the provided edge-data.
-    for (const auto& edge_type: data.edges) {
-        if (edge_type.edge_type.find('\n') != std::string::npos) {
-            throw std::runtime_error("Newline-Characters are not allowed as part of the edge-type given: " + edge_type.edge_type);
+        writer.append('\n');
+
+        // Write the provided node-data.
+        writer.append("# NODES\n");
+        for (const auto& [startID, endID, node_type]: data.nodes) {
+            if (node_type.find('\n') != std::string::npos) {
+                throw std::runtime_error("Newline-Characters are not allowed as part of the node-type given: " + node_type);
+            }
+            writer.append_id(scaled_id(startID, data.scale));
+            writer.append(',');
+            writer.append_id(scaled_id(endID, data.scale));
+            writer.append(',');
+            writer.append(node_type);
+            writer.append('\n');
         }
-        out_file << "# EDGES=" << edge_type.edge_type << std::endl;
-        std::string edge_str;
-        edge_str.reserve(RESERVED_BYTES_FOR_STRING_CONSTRUCTION);
-        // #pragma omp parallel for private(edge_str)
-        for (auto &[startX, endX, startY, endY, expression_probability] : edge_type.blocks) {
-            // if (expression_probability > 1.0f || expression_probability < 0.0f) {throw std::runtime_error("All expression-probabilities must be in the Interval [0,1].");}
-            edge_str = "";
-            edge_str.append(std::to_string(startX));
-            edge_str.push_back(',');
-            edge_str.append(std::to_string(endX));
-            edge_str.push_back(',');
-            edge_str.append(std::to_string(startY));
-            edge_str.push_back(',');
-            edge_str.append(std::to_string(endY));
-            edge_str.push_back(',');
-            edge_str.append(std::to_string(expression_probability));
-            edge_str.push_back('\n');
-            out_file << edge_str;
+        writer.append('\n');
+
+        // Write the provided edge-data.
+        for (const auto& edge_type: data.edges) {
+            if (edge_type.edge_type.find('\n') != std::string::npos) {
+                throw std::runtime_error("Newline-Characters are not allowed as part of the edge-type given: " + edge_type.edge_type);
+            }
+            writer.append("# EDGES=");
+            writer.append(edge_type.edge_type);
+            writer.append('\n');
+            for (const Edge_Block& block: edge_type.blocks) {
+                const auto [startX, endX, startY, endY, expression_probability] = scaled_block(block, data.scale);
+                writer.append_id(startX);
+                writer.append(',');
+                writer.append_id(endX);
+                writer.append(',');
+                writer.append_id(startY);
+                writer.append(',');
+                writer.append_id(endY);
+                writer.append(',');
+                writer.append_number(expression_probability, std::chars_format::general);
+                writer.append('\n');
+            }
+            writer.append('\n');
         }
-        out_file << std::endl;
+        writer.flush();
     }
+    out_file.finish();
 
-    return static_cast<size_t>(out_file.tellp()) - bytes_at_start;
+    return std::filesystem::file_size(file_path);
 }
 
 // Scale the size of a given graph described by the m1_data-struct with a non-zero scaling factor.
-// A completely new struct is constructed (~deep copy) without side effects on the passed struct.
-m1_data scale_m1_data(m1_data& data, const float scale) {
+// The factor is only multiplied into the scale of the model, which takes constant time. Consecutive factors are thus
+//      composed before any ID is rounded, the blocks are scaled once when a graph is generated or the model is saved.
+void scale_m1_data(m1_data& data, const float scale) {
     if (scale == 0.0f) {throw std::runtime_error("Scale must be greater than zero.");}
     if (scale < 1.0f) {std::cerr << "\tWarning: Downscaling a dataset can have a serious impact on the resulting graphs! Proceed with caution." << std::endl;}
 
-    m1_data result = {};
-    result.meta.name = data.meta.name;
-    for (const auto& [k, v]: data.meta.values) {
-        result.meta.values[k] = v;
-    }
-
     // Set a new key in the META-Block to indicate the new scale of the model, relative to the original graph.
     double old_scale = 1.0f;
     if (data.meta.values.contains("SCALE")) {
@@ -357,45 +645,8 @@ m1_data scale_m1_data(m1_data& data, const float scale) {
                       <<  "The new value of SCALE may not be accurate." << std::endl;
         }
     }
-    result.meta.values["SCALE"] = std::to_string(old_scale * scale);
-
-    // As we allow continuous ranges of nodes in the m1-format, scaling is as simple as multiplying the
-    //      both elements of the range by the scaling factor.
-    result.nodes.reserve(result.nodes.size());
-    for (const auto& [startID, endID, node_type]: data.nodes) {
-        result.nodes.emplace_back(Node_Record(startID*scale, endID*scale, node_type));
-    }
-
-    result.edges.reserve(data.edges.size());
-    Amount new_model_failures = 0;
-    Amount total_blocks = 0;
-    for (const auto& [edge_type, blocks]: data.edges) {
-        Edge_Record r = {};
-        r.edge_type = edge_type;
-        r.blocks.reserve(blocks.size());
-
-        for (auto [startX, endX, startY, endY, expression_probability]: blocks) {
-            // As the number of nodes is increased, the expression-probability needs to be reduced by the same factor.
-            //      This retains the expected In-/Out-Degrees of the nodes.
-            Probability adapted_probability = expression_probability / scale;
-            // Clamp the probability to a maximum of 1.0 and warn the user. This should only happen when scaling down graphs.
-            if (adapted_probability > 1.0f) {
-                adapted_probability = 1.0f;
-                ++new_model_failures;
-            }
-            r.blocks.emplace_back(Edge_Block(startX*scale, endX*scale, startY*scale, endY*scale, adapted_probability));
-            ++total_blocks;
-        }
-        result.edges.emplace_back(r);
-    }
+    data.meta.values["SCALE"] = std::to_string(old_scale * scale);
+    data.scale *= scale;
 
-    std::cout << "\tNew scale: x" << result.meta.values["SCALE"] << " of original." << std::endl;
-
-    if (new_model_failures > 0) {
-        std::cerr << '\t' << new_model_failures << " (" << new_model_failures / (total_blocks / static_cast<long double>(100))
-            << "%) model-failures (block-probability > 1.0) remaining after scaling." << std::endl;
-    }
-
-    return result;
+    std::cout << "\tNew scale: x" << data.meta.values["SCALE"] << " of original." << std::endl;
 }
-
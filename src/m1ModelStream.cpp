@@ -0,0 +1,140 @@
+/*
+ *  Reads the blocks of a model-file in windows, without loading the whole model into memory. Used by -Stream, for
+ *  models that are larger than the available memory. Text models are read sequentially and may be compressed, binary
+ *  models are mapped and copied window by window, so only the pages of the current window are held.
+ */
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class M1_Block_Stream {
+public:
+    // Reads the META- and NODES-sections of the model, which must precede all EDGES-sections.
+    explicit M1_Block_Stream(const std::string& file_name_): file_name(file_name_) {
+        if (is_m1_binary_file(this->file_name)) {
+            this->binary_model = std::make_unique<m1_data>(read_m1_binary_file(this->file_name));
+            this->model_header.meta = this->binary_model->meta;
+            this->model_header.nodes = this->binary_model->nodes;
+            return;
+        }
+
+        if (!std::filesystem::is_regular_file(this->file_name)) {
+            throw std::runtime_error("Failed to open file " + this->file_name + ".");
+        }
+        // Plain files are read ahead in blocks as well, which keeps the memory bounded unlike a mapping.
+        this->text_file = std::make_unique<Decompressing_Reader>(this->file_name, detect_compression(this->file_name), TEXT_BLOCK_SIZE);
+
+        bool has_meta = false, has_node = false;
+        bool in_nodes = false;
+        std::string_view line;
+        while (this->next_text_line(line)) {
+            if (line.starts_with('#')) {
+                if (line.starts_with("# META")) {in_nodes = false;}
+                else if (line.starts_with("# NODES")) {in_nodes = true;}
+                else if (line.starts_with("# EDGES")) {
+                    this->current_edge_type = line.substr(line.find('=') + 1);
+                    this->in_edges = true;
+                    break;
+                } else {
+                    throw std::runtime_error("Encountered unexpected directive '" + std::string(line)
+                        + "' while parsing m1-file (" + this->file_name + "). The file may be malformed.");
+                }
+                this->in_header = true;
+                continue;
+            }
+            if (!this->in_header) {
+                throw std::runtime_error("Encountered unexpected line '" + std::string(line)
+                    + "' in mode NONE while parsing m1-file (" + this->file_name + ").");
+            }
+            if (in_nodes) {
+                has_node |= parse_m1_node_line(line, this->file_name, this->model_header.nodes);
+            } else {
+                has_meta |= parse_m1_meta_line(line, this->file_name, this->model_header.meta);
+            }
+        }
+
+        if (!has_meta) {throw std::runtime_error("'" + this->file_name + "' is missing a valid META-Section with at least a 'NAME=...' declaration.");}
+        if (!has_node) {throw std::runtime_error("'" + this->file_name + "' is missing a valid NODES-Section with at least one node type. Streamed models must declare their nodes before their edges.");}
+        if (!this->in_edges) {throw std::runtime_error("'" + this->file_name + "' is missing a valid EDGES-Section with at least an edge type.");}
+    }
+
+    M1_Block_Stream(const M1_Block_Stream&) = delete;
+    M1_Block_Stream& operator=(const M1_Block_Stream&) = delete;
+
+    // The meta-data and the nodes of the model. Holds no edges.
+    [[nodiscard]] const m1_data& header() const {return this->model_header;}
+
+    // Reads up to max_blocks of the next blocks, which all belong to the returned edge-type. Returns false once all
+    //  blocks were read.
+    bool next(std::string& edge_type, std::vector<Edge_Block>& blocks, const size_t max_blocks) {
+        blocks.clear();
+        if (this->binary_model) {
+            while (this->binary_edge_type < this->binary_model->edges.size()) {
+                const Edge_Record& record = this->binary_model->edges[this->binary_edge_type];
+                if (this->binary_position < record.blocks.size()) {
+                    const size_t n = std::min(max_blocks, record.blocks.size() - this->binary_position);
+                    blocks.assign(record.blocks.begin() + this->binary_position, record.blocks.begin() + this->binary_position + n);
+                    this->binary_position += n;
+                    edge_type = record.edge_type;
+                    return true;
+                }
+                ++this->binary_edge_type;
+                this->binary_position = 0;
+            }
+            return false;
+        }
+
+        std::string_view line;
+        while (blocks.size() < max_blocks && this->next_text_line(line)) {
+            if (line.starts_with('#')) {
+                if (!line.starts_with("# EDGES")) {
+                    throw std::runtime_error("Encountered '" + std::string(line) + "' after the first EDGES-section of m1-file ("
+                        + this->file_name + "). Streamed models must declare their meta-data and nodes before their edges.");
+                }
+                // Blocks of the previous edge-type are returned first.
+                std::string next_edge_type(line.substr(line.find('=') + 1));
+                if (!blocks.empty()) {
+                    edge_type = std::move(this->current_edge_type);
+                    this->current_edge_type = std::move(next_edge_type);
+                    return true;
+                }
+                this->current_edge_type = std::move(next_edge_type);
+                continue;
+            }
+            parse_m1_edge_line(line, this->file_name, blocks, std::cerr);
+        }
+        edge_type = this->current_edge_type;
+        return !blocks.empty();
+    }
+
+private:
+    static constexpr size_t TEXT_BLOCK_SIZE = 1 << 20;
+
+    // Returns the next non-empty line of a text model without a trailing \r. The line is valid until the block it
+    //  was taken from is exhausted, edge-types are therefore copied.
+    bool next_text_line(std::string_view& line) {
+        while (true) {
+            while (!this->text_block.empty()) {
+                line = next_m1_field(this->text_block, '\n');
+                if (line.ends_with('\r')) {line.remove_suffix(1);}
+                if (!line.empty()) {return true;}
+            }
+            if (!this->text_file->next_block(this->text_block)) {return false;}
+        }
+    }
+
+    std::string file_name;
+    m1_data model_header;
+
+    std::unique_ptr<m1_data> binary_model;
+    size_t binary_edge_type = 0;
+    size_t binary_position = 0;
+
+    std::unique_ptr<Decompressing_Reader> text_file;
+    std::string_view text_block;
+    std::string current_edge_type;
+    bool in_header = false;
+    bool in_edges = false;
+};
@@ -9,16 +9,24 @@
  *      +nodetypeindex [index_of_node_type1] [index_of_node_type2] ...
  *      +edgeindex [index_of_start_node] [index_of_end_node]
  *      +edgetypeindex [index_of_edge_type1] [index_of_edge_type2] ...
+ *      +nodeids [auto|numeric|text]
+ *      +aggregation [records|sort]
+ *      +degreeclasses [log|count] [ratio|number_of_classes]
+ *      +memory [memory_budget_in_MB]
+ *      +tempdir [path_to_temporary_directory]
  *      +arg [KEY] [VALUE]
  *
  *  -Execute [path_to_script] [template1] [replace1] [template2] [replace2] ...
  *
  *  -Load [path_to_model_file]
- *  -Save [model_save_path]
+ *  -Stream [path_to_model_file]
+ *  -Save [model_save_path]              // Binary format for paths ending in '.m1b', compressed for '.gz' and '.zst'.
  *
  *  -Scale [scaling_factor]
  *  -Seed [seed_string]
  *  -Generate [generated_nodefile_path] [generated_edgefile_path] [number_of_graphs]
+ *  -Threads [number_of_threads]
+ *  -Affinity [on|off]
  *
  *  -Help
  *
@@ -28,6 +36,8 @@
 #include <string>
 #include <iostream>
 #include <bits/ranges_algo.h>
+#include "../src/graphgenerator_intern.h"
+#include "../src/graphgenerator_types.h"
 
 struct Read_Instruction {
     // Path(s) to the data-file(s)
@@ -43,6 +53,20 @@ struct Read_Instruction {
     std::size_t end_node_index;     // (Unique) Name of the end-node
     std::vector<std::size_t> edge_type_indices; // Composite-key for the edge-type
 
+    // Interpretation of the node-IDs. Numeric IDs are interned without hashing strings.
+    Node_ID_Mode node_id_mode = Node_ID_Mode::Auto;
+
+    // Counting of the degrees of the nodes in memory.
+    Degree_Aggregation degree_aggregation = Degree_Aggregation::Records;
+
+    // Grouping of the degrees into classes before the model is built.
+    Degree_Classes degree_classes = {};
+
+    // Graphs are read in memory, unless a memory budget (in MB) is given. With a budget, the graph is sorted on disk
+    //  in the temporary directory. Uses the system's temporary directory if none is given.
+    std::size_t memory_budget = 0;
+    std::string temp_directory;
+
     // Addition meta-data for the graph.
     std::map<std::string, std::string> data;
 };
@@ -67,7 +91,10 @@ enum Instruction_Type {
     ISave,
     ISeed,
     IHelp,
-    IInfo
+    IInfo,
+    IThreads,
+    IAffinity,
+    IStream
 };
 
 // I tried to make this a union, the compiler was not impressed. I can live with wasting some space.
@@ -75,6 +102,7 @@ struct Instruction {
     Instruction_Type type;
     std::string s_val = "";
     std::float_t f_val = 0.0f;
+    std::size_t u_val = 0;
     Read_Instruction read = {};
     Generate_Instruction generate = {};
     Execute_Instruction execute = {};
@@ -283,7 +311,7 @@ std::vector<Instruction> parse_s1_file(const std::vector<std::pair<Token_Type, s
                                 idx = std::stoul(tokens[current_idx_sub_instruction+1].second);
                             } catch (std::exception &e) {
                                 throw std::runtime_error("Could not convert argument '" +
-                                    tokens[current_idx_sub_instruction+1].second + "' of NODEINDEX-Instruction to an unsinged int. " + e.what());
+                                    tokens[current_idx_sub_instruction+1].second + "' of NODEINDEX-Instruction to an unsigned int. " + e.what());
                             }
                             i.node_name_index = idx;
 
@@ -298,7 +326,7 @@ std::vector<Instruction> parse_s1_file(const std::vector<std::pair<Token_Type, s
                                         idx = std::stoul(tokens[arg_idx].second);
                                     } catch (std::exception &e) {
                                         throw std::runtime_error("Could not convert argument '" +
-                                            tokens[arg_idx].second + "' of NODETYPEINDEX-Instruction to an unsinged int. " + e.what());
+                                            tokens[arg_idx].second + "' of NODETYPEINDEX-Instruction to an unsigned int. " + e.what());
                                     }
                                     if (!overwritten_default_node_type_index) {i.node_type_indices.clear();}
                                     i.node_type_indices.emplace_back(idx);
@@ -324,13 +352,13 @@ std::vector<Instruction> parse_s1_file(const std::vector<std::pair<Token_Type, s
                                 idx_s = std::stoul(tokens[current_idx_sub_instruction+1].second);
                             } catch (std::exception &e) {
                                 throw std::runtime_error("Could not convert argument '" +
-                                    tokens[current_idx_sub_instruction+1].second + "' of EDGEINDEX-Instruction to an unsinged int. " + e.what());
+                                    tokens[current_idx_sub_instruction+1].second + "' of EDGEINDEX-Instruction to an unsigned int. " + e.what());
                             }
                             try {
                                 idx_e = std::stoul(tokens[current_idx_sub_instruction+2].second);
                             } catch (std::exception &e) {
                                 throw std::runtime_error("Could not convert argument '" +
-                                    tokens[current_idx_sub_instruction+2].second + "' of EDGEINDEX-Instruction to an unsinged int. " + e.what());
+                                    tokens[current_idx_sub_instruction+2].second + "' of EDGEINDEX-Instruction to an unsigned int. " + e.what());
                             }
                             i.start_node_index = idx_s;
                             i.end_node_index = idx_e;
@@ -346,7 +374,7 @@ std::vector<Instruction> parse_s1_file(const std::vector<std::pair<Token_Type, s
                                         idx = std::stoul(tokens[arg_idx].second);
                                     } catch (std::exception &e) {
                                         throw std::runtime_error("Could not convert argument '" +
-                                            tokens[arg_idx].second + "' of EDGETYPEINDEX-Instruction to an unsinged int. " + e.what());
+                                            tokens[arg_idx].second + "' of EDGETYPEINDEX-Instruction to an unsigned int. " + e.what());
                                     }
                                     if (!overwritten_default_edge_type_index) {i.edge_type_indices.clear();}
                                     i.edge_type_indices.emplace_back(idx);
@@ -358,6 +386,93 @@ std::vector<Instruction> parse_s1_file(const std::vector<std::pair<Token_Type, s
                             }
 
 
+                        } else if (tokens[current_idx_sub_instruction].second == "+NODEIDS") {
+                            // Select how the node-IDs are interpreted. AUTO reads IDs as numbers as long as this does
+                            //      not change their meaning, NUMERIC always reads them as numbers, TEXT never does.
+                            s1_check_parse_valid(idx_end_of_sub_instruction-current_idx_sub_instruction, 1,
+                                         tokens[current_idx_sub_instruction+1].first, Token_Type::TArgument, "+NODEIDS");
+                            std::string mode = tokens[current_idx_sub_instruction+1].second;
+                            std::ranges::transform(mode, mode.begin(), ::toupper);
+                            if (mode == "AUTO") {
+                                i.node_id_mode = Node_ID_Mode::Auto;
+                            } else if (mode == "NUMERIC") {
+                                i.node_id_mode = Node_ID_Mode::Numeric;
+                            } else if (mode == "TEXT") {
+                                i.node_id_mode = Node_ID_Mode::Text;
+                            } else {
+                                throw std::runtime_error("Argument '" + tokens[current_idx_sub_instruction+1].second
+                                    + "' of NODEIDS-Instruction must be one of AUTO, NUMERIC or TEXT.");
+                            }
+
+
+                        } else if (tokens[current_idx_sub_instruction].second == "+AGGREGATION") {
+                            // Select how the degrees are counted. RECORDS increments the degrees of the nodes for every
+                            //      edge, SORT sorts the endpoints of all edges once they are read.
+                            s1_check_parse_valid(idx_end_of_sub_instruction-current_idx_sub_instruction, 1,
+                                         tokens[current_idx_sub_instruction+1].first, Token_Type::TArgument, "+AGGREGATION");
+                            std::string mode = tokens[current_idx_sub_instruction+1].second;
+                            std::ranges::transform(mode, mode.begin(), ::toupper);
+                            if (mode == "RECORDS") {
+                                i.degree_aggregation = Degree_Aggregation::Records;
+                            } else if (mode == "SORT") {
+                                i.degree_aggregation = Degree_Aggregation::Sort;
+                            } else {
+                                throw std::runtime_error("Argument '" + tokens[current_idx_sub_instruction+1].second
+                                    + "' of AGGREGATION-Instruction must be one of RECORDS or SORT.");
+                            }
+
+
+                        } else if (tokens[current_idx_sub_instruction].second == "+DEGREECLASSES") {
+                            // Group the degrees into classes. LOG expects the ratio between the bounds of a class,
+                            //      COUNT the number of logarithmic classes per degree-distribution.
+                            s1_check_parse_valid(idx_end_of_sub_instruction-current_idx_sub_instruction, 2,
+                                         tokens[current_idx_sub_instruction+1].first, Token_Type::TArgument, "+DEGREECLASSES");
+                            s1_check_parse_valid(idx_end_of_sub_instruction-current_idx_sub_instruction, 2,
+                                     tokens[current_idx_sub_instruction+2].first, Token_Type::TArgument, "+DEGREECLASSES");
+                            std::string mode = tokens[current_idx_sub_instruction+1].second;
+                            std::ranges::transform(mode, mode.begin(), ::toupper);
+                            const std::string& value = tokens[current_idx_sub_instruction+2].second;
+                            try {
+                                if (mode == "LOG") {
+                                    i.degree_classes.binning = Degree_Binning::Logarithmic;
+                                    i.degree_classes.ratio = std::stold(value);
+                                } else if (mode == "COUNT") {
+                                    i.degree_classes.binning = Degree_Binning::Count;
+                                    i.degree_classes.count = std::stoul(value);
+                                } else {
+                                    throw std::runtime_error("Argument '" + tokens[current_idx_sub_instruction+1].second
+                                        + "' of DEGREECLASSES-Instruction must be one of LOG or COUNT.");
+                                }
+                            } catch (std::invalid_argument &e) {
+                                throw std::runtime_error("Could not convert argument '" + value + "' of DEGREECLASSES-Instruction to a number. " + e.what());
+                            } catch (std::out_of_range &e) {
+                                throw std::runtime_error("Could not convert argument '" + value + "' of DEGREECLASSES-Instruction to a number. " + e.what());
+                            }
+                            if ((i.degree_classes.binning == Degree_Binning::Logarithmic && !(i.degree_classes.ratio > 1))
+                                || (i.degree_classes.binning == Degree_Binning::Count && i.degree_classes.count == 0)) {
+                                throw std::runtime_error("DEGREECLASSES-Instruction expects a ratio larger than 1 or at least one class.");
+                            }
+
+
+                        } else if (tokens[current_idx_sub_instruction].second == "+MEMORY") {
+                            // Read the graph on disk, using roughly the given amount of memory (in MB). 0 reads in memory.
+                            s1_check_parse_valid(idx_end_of_sub_instruction-current_idx_sub_instruction, 1,
+                                         tokens[current_idx_sub_instruction+1].first, Token_Type::TArgument, "+MEMORY");
+                            try {
+                                i.memory_budget = std::stoul(tokens[current_idx_sub_instruction+1].second);
+                            } catch (std::exception &e) {
+                                throw std::runtime_error("Could not convert argument '" +
+                                    tokens[current_idx_sub_instruction+1].second + "' of MEMORY-Instruction to an unsigned int. " + e.what());
+                            }
+
+
+                        } else if (tokens[current_idx_sub_instruction].second == "+TEMPDIR") {
+                            // Directory for the temporary files of graphs that are read on disk.
+                            s1_check_parse_valid(idx_end_of_sub_instruction-current_idx_sub_instruction, 1,
+                                         tokens[current_idx_sub_instruction+1].first, Token_Type::TArgument, "+TEMPDIR");
+                            i.temp_directory = tokens[current_idx_sub_instruction+1].second;
+
+
                         } else if (tokens[current_idx_sub_instruction].second == "+ARG") {
                             // Pass additional meta-data to the model. Expects two values, forming a key-value-pair.
                             s1_check_parse_valid(idx_end_of_sub_instruction-current_idx_sub_instruction, 2,
@@ -429,6 +544,16 @@ std::vector<Instruction> parse_s1_file(const std::vector<std::pair<Token_Type, s
                 instructions.emplace_back(i);
 
 
+            } else if (tokens[current_idx].second == "-STREAM") {
+                // Use a m1-file as the active model without loading its blocks. Validity/Permission for the given filepath are only checked on execution.
+                s1_check_parse_valid(idx_end_of_instruction-current_idx, 1,
+                                         tokens[idx_end_of_instruction].first, Token_Type::TArgument, "STREAM");
+                Instruction i = {};
+                i.type = Instruction_Type::IStream;
+                i.s_val = tokens[idx_end_of_instruction].second;
+                instructions.emplace_back(i);
+
+
             } else if (tokens[current_idx].second == "-SAVE") {
                 // Save the currently active model to a file. Validity/Permission for the given filepath are only checked on execution.
                 s1_check_parse_valid(idx_end_of_instruction-current_idx, 1,
@@ -495,6 +620,36 @@ std::vector<Instruction> parse_s1_file(const std::vector<std::pair<Token_Type, s
                 instructions.emplace_back(i);
 
 
+            } else if (tokens[current_idx].second == "-THREADS") {
+                // Set the number of worker-threads used for generation. 0 restores the default (all but one hardware thread).
+                s1_check_parse_valid(idx_end_of_instruction-current_idx, 1,
+                                         tokens[current_idx+1].first, Token_Type::TArgument, "THREADS");
+                Instruction i = {};
+                i.type = Instruction_Type::IThreads;
+                try {
+                    i.u_val = std::stoul(tokens[current_idx+1].second);
+                } catch (std::exception &e) {
+                    throw std::runtime_error("Could not convert argument '" +
+                        tokens[current_idx+1].second + "' of THREADS-Instruction to an unsigned integer. " + e.what());
+                }
+                instructions.emplace_back(i);
+
+
+            } else if (tokens[current_idx].second == "-AFFINITY") {
+                // Pin the worker-threads used for generation to individual cores. Accepts ON or OFF.
+                s1_check_parse_valid(idx_end_of_instruction-current_idx, 1,
+                                         tokens[current_idx+1].first, Token_Type::TArgument, "AFFINITY");
+                std::string mode = tokens[current_idx+1].second;
+                std::ranges::transform(mode, mode.begin(), ::toupper);
+                if (mode != "ON" && mode != "OFF") {
+                    throw std::runtime_error("Argument '" + tokens[current_idx+1].second + "' of AFFINITY-Instruction must be either ON or OFF.");
+                }
+                Instruction i = {};
+                i.type = Instruction_Type::IAffinity;
+                i.s_val = mode;
+                instructions.emplace_back(i);
+
+
             } else if (tokens[current_idx].second == "-HELP") {
                 // Display the program usage documentation.
                 Instruction i = {};
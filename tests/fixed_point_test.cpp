@@ -0,0 +1,82 @@
+/*
+ *  Compares the integer NodeIDs recovered from fixed-point IDs with those of long double IDs, which the model used
+ *  before, at awkward scales: Directly at a scale, after saving a model at a scale and loading it, and after scaling
+ *  such a loaded model once more.
+ */
+
+#include "../src/m1ModelFormat.cpp"
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+constexpr NodeID N_IDS = 200000;
+
+// The integer part of an ID held as a long double and scaled by each of the factors in turn.
+NodeID long_double_integer_part(const NodeID id, const std::vector<float>& scales) {
+    long double value = id;
+    for (const float scale: scales) {value = value * scale;}
+    return static_cast<NodeID>(value);
+}
+
+int main() {
+    const std::vector<float> scales = {3.0f, 1.0f / 3.0f, 7.0f, 1.0f / 7.0f, 0.37f, 2.5f, 0.4f, 1.1f, 1.0f / 1.1f};
+    size_t failures = 0;
+    auto check = [&failures](const NodeID expected, const NodeID actual, const std::string& description) {
+        if (expected != actual) {
+            if (failures < 20) {
+                std::cerr << description << ": expected " << expected << ", got " << actual << "." << std::endl;
+            }
+            ++failures;
+        }
+    };
+
+    // Generating at a scale, or at the product of two scales, which are multiplied before they are applied.
+    for (const float scale: scales) {
+        for (const float second_scale: scales) {
+            const long double product = static_cast<long double>(scale) * second_scale;
+            for (NodeID id = 0; id < N_IDS; ++id) {
+                check(static_cast<NodeID>(id * product), scaled_integer_part(ContinuousNodeID(id), product),
+                    "ID " + std::to_string(id) + " at scale " + std::to_string(scale) + " * " + std::to_string(second_scale));
+            }
+        }
+    }
+
+    // Saving a model at a scale and loading it gives the same IDs as generating at that scale.
+    const std::filesystem::path file = std::filesystem::temp_directory_path() / "graphgenerator_fixed_point_test.m1";
+    auto save_and_load = [&file](const float scale) {
+        m1_data data = {};
+        data.meta.name = "Fixed-Point Test";
+        for (NodeID id = 0; id < N_IDS; ++id) {
+            data.nodes.push_back(Node_Record{ContinuousNodeID(id), ContinuousNodeID(id + 1), "node"});
+        }
+        data.edges.push_back(Edge_Record{"edge", std::vector<Edge_Block>{
+            Edge_Block{ContinuousNodeID(0), ContinuousNodeID(1), ContinuousNodeID(0), ContinuousNodeID(1), 0.5f}}});
+        data.scale = scale;
+        write_m1_file(file.string(), data);
+        return read_m1_file(file.string());
+    };
+    for (const float scale: scales) {
+        const m1_data loaded = save_and_load(scale);
+        for (NodeID id = 0; id < N_IDS; ++id) {
+            check(long_double_integer_part(id, {scale}), scaled_integer_part(loaded.nodes[id].startID, 1),
+                "ID " + std::to_string(id) + " saved at scale " + std::to_string(scale));
+        }
+    }
+
+    // Scaling a saved model back, for the scales whose products are not close enough to integers to be affected by
+    //  rounding the saved IDs to 24 binary decimals.
+    const std::vector<std::pair<float, float>> rescales = {{1.0f / 3.0f, 3.0f}, {3.0f, 1.0f / 3.0f}, {0.37f, 1.0f / 0.37f}};
+    for (const auto& [scale, second_scale]: rescales) {
+        const m1_data loaded = save_and_load(scale);
+        for (NodeID id = 0; id < N_IDS; ++id) {
+            check(long_double_integer_part(id, {scale, second_scale}), scaled_integer_part(loaded.nodes[id].startID, second_scale),
+                "ID " + std::to_string(id) + " saved at scale " + std::to_string(scale) + ", scaled by " + std::to_string(second_scale));
+        }
+    }
+    std::filesystem::remove(file);
+
+    std::cout << failures << " mismatch(es)." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
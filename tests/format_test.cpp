@@ -0,0 +1,54 @@
+/*
+ *  Compares unsafe_u64Int_to_str with std::to_chars at the boundaries of its digit count and of its two-digit table:
+ *  Around every power of ten and every power of two, for all pairs of the last two digits there, and at UINT64_MAX.
+ */
+
+#include "../src/graphgenerator_format.h"
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+int main() {
+    std::vector<std::uint64_t> values;
+    // Every entry of the table in every position of the small values.
+    for (std::uint64_t value = 0; value <= 100000; ++value) {values.push_back(value);}
+    // Powers of ten +-1 change the digit count, the 100 values around them cover every final digit-pair on both sides.
+    for (const std::uint64_t power: POWERS_OF_10) {
+        for (std::uint64_t offset = 0; offset <= 100; ++offset) {
+            values.push_back(power - offset);
+            values.push_back(power + offset);
+        }
+    }
+    // Powers of two change the bit width, from which the digit count is approximated.
+    for (int bit = 0; bit < 64; ++bit) {
+        const std::uint64_t power = std::uint64_t(1) << bit;
+        for (std::uint64_t offset = 0; offset <= 2; ++offset) {
+            values.push_back(power - offset);
+            values.push_back(power + offset);
+        }
+    }
+    for (std::uint64_t offset = 0; offset <= 100; ++offset) {
+        values.push_back(std::numeric_limits<std::uint64_t>::max() - offset);
+    }
+
+    size_t failures = 0;
+    for (const std::uint64_t value: values) {
+        char expected[32] = {};
+        const auto [end, error] = std::to_chars(expected, expected + sizeof(expected), value);
+        char actual[32];
+        std::memset(actual, 'x', sizeof(actual));
+        const int length = unsafe_u64Int_to_str(actual, value);
+        if (error != std::errc() || length != end - expected || std::memcmp(actual, expected, length + 1) != 0
+            || count_u64_digits(value) != length) {
+            std::cerr << "Mismatch for " << value << ": expected '" << std::string(expected, end) << "', got '"
+                << std::string(actual, std::max(length, 0)) << "' (" << length << " digits)." << std::endl;
+            ++failures;
+        }
+    }
+
+    std::cout << "Checked " << values.size() << " values, " << failures << " mismatch(es)." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
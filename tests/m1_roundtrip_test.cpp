@@ -0,0 +1,121 @@
+/*
+ *  Round-trips the bundled models through read_m1_file and write_m1_file: load -> save -> load -> save.
+ *  Both loaded models must hold the same data and both saved files must have the same bytes. Run with the directory
+ *  of the models. The zipped model is only read when built with zlib, compressed saves are tested where supported.
+ */
+
+#include "../src/m1ModelFormat.cpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Describes the first difference between the two models, empty if they hold the same data.
+std::string first_difference(const m1_data& lhs, const m1_data& rhs) {
+    if (lhs.meta.name != rhs.meta.name || lhs.meta.values != rhs.meta.values) {return "meta-data";}
+    if (lhs.scale != rhs.scale) {return "scale";}
+    if (lhs.nodes.size() != rhs.nodes.size()) {return "number of node-records";}
+    for (size_t idx = 0; idx < lhs.nodes.size(); ++idx) {
+        const Node_Record& left = lhs.nodes[idx];
+        const Node_Record& right = rhs.nodes[idx];
+        if (left.startID != right.startID || left.endID != right.endID || left.node_type != right.node_type) {
+            return "node-record " + std::to_string(idx);
+        }
+    }
+    if (lhs.edges.size() != rhs.edges.size()) {return "number of edge-types";}
+    for (size_t type_idx = 0; type_idx < lhs.edges.size(); ++type_idx) {
+        const Edge_Record& left = lhs.edges[type_idx];
+        const Edge_Record& right = rhs.edges[type_idx];
+        if (left.edge_type != right.edge_type || left.blocks.size() != right.blocks.size()) {
+            return "edge-type " + std::to_string(type_idx);
+        }
+        for (size_t idx = 0; idx < left.blocks.size(); ++idx) {
+            const Edge_Block& a = left.blocks[idx];
+            const Edge_Block& b = right.blocks[idx];
+            if (a.startX != b.startX || a.endX != b.endX || a.startY != b.startY || a.endY != b.endY
+                || a.expression_probability != b.expression_probability) {
+                return "block " + std::to_string(idx) + " of edge-type " + left.edge_type;
+            }
+        }
+    }
+    return "";
+}
+
+std::string file_content(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// Returns an empty string on success, otherwise the reason of the failure.
+std::string round_trip(const std::filesystem::path& model, const std::filesystem::path& directory, const std::string& extension) {
+    const std::string first_file = (directory / ("first" + extension)).string();
+    const std::string second_file = (directory / ("second" + extension)).string();
+
+    const m1_data first = read_m1_file(model.string());
+    write_m1_file(first_file, first);
+    const m1_data second = read_m1_file(first_file);
+    write_m1_file(second_file, second);
+
+    if (const std::string difference = first_difference(first, second); !difference.empty()) {
+        return "The loaded models differ in their " + difference + ".";
+    }
+    if (file_content(first_file) != file_content(second_file)) {
+        return "The saved files differ.";
+    }
+    return "";
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: m1_roundtrip_test <directory of the models>" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> models;
+    for (const auto& entry: std::filesystem::directory_iterator(argv[1])) {
+        if (entry.path().extension() == ".m1") {models.push_back(entry.path());}
+    }
+#ifdef GRAPHGENERATOR_WITH_ZLIB
+    models.push_back(std::filesystem::path(argv[1]) / "stark_prime_model.zip");
+#endif
+    std::ranges::sort(models);
+    if (models.empty()) {
+        std::cerr << "No models found in " << argv[1] << "." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> extensions = {".m1"};
+#ifdef GRAPHGENERATOR_WITH_ZLIB
+    extensions.emplace_back(".m1.gz");
+#endif
+#ifdef GRAPHGENERATOR_WITH_ZSTD
+    extensions.emplace_back(".m1.zst");
+#endif
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "graphgenerator_m1_roundtrip_test";
+    std::filesystem::create_directories(directory);
+
+    size_t failures = 0;
+    for (const auto& model: models) {
+        for (const auto& extension: extensions) {
+            std::string failure;
+            try {
+                failure = round_trip(model, directory, extension);
+            } catch (const std::exception& e) {
+                failure = e.what();
+            }
+            if (!failure.empty()) {
+                std::cerr << "Round-trip of " << model.filename().string() << " as " << extension << " failed: " << failure << std::endl;
+                ++failures;
+            }
+        }
+    }
+    std::filesystem::remove_all(directory);
+
+    std::cout << "Round-tripped " << models.size() << " model(s) as " << extensions.size() << " format(s), "
+        << failures << " failure(s)." << std::endl;
+    return failures == 0 ? 0 : 1;
+}